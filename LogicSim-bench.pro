@@ -0,0 +1,16 @@
+TEMPLATE = app
+TARGET = logicsim-bench
+
+# simulation benchmark, links only the model and circuit generators
+QT =
+CONFIG += c++17 console release
+CONFIG -= qt app_bundle
+
+include(model.pri)
+
+SOURCES += \
+    src/tools/generators.cpp \
+    tools/bench/main.cpp
+
+HEADERS += \
+    include/tools/generators.hpp
@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = logicsim-cli
+
+# headless simulator, links only the model
+QT =
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+include(model.pri)
+
+SOURCES += \
+    tools/cli/main.cpp
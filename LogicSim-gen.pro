@@ -0,0 +1,16 @@
+TEMPLATE = app
+TARGET = logicsim-gen
+
+# circuit file generator, links only the model and circuit generators
+QT =
+CONFIG += c++17 console
+CONFIG -= qt app_bundle
+
+include(model.pri)
+
+SOURCES += \
+    src/tools/generators.cpp \
+    tools/gen/main.cpp
+
+HEADERS += \
+    include/tools/generators.hpp
@@ -1,9 +1,16 @@
 #ifndef LOGICSIM_GUI_COMPONENT_HPP
 #define LOGICSIM_GUI_COMPONENT_HPP
 
-#include <QLabel>
+#include <QContextMenuEvent>
+#include <QMenu>
 #include <QMouseEvent>
+#include <QObject>
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <QTransform>
 #include <QUndoStack>
+#include <QWidget>
 
 #include <fstream>
 #include <string>
@@ -15,6 +22,8 @@
 
 #include "model/component.hpp"
 #include "model/mapped_data.hpp"
+#include "model/runner.hpp"
+#include "model/watchpoint.hpp"
 
 #include "utils.hpp"
 
@@ -24,88 +33,159 @@ namespace gui
 {
 class ChangeComponentPropertyCommand;
 
-class ComponentLabel : public QLabel
+// component as drawn on the design area
+// components are not widgets; the design area (parent) paints them and
+// forwards mouse events to the one under the cursor, in local coordinates
+// position and size are native (untransformed), as are the local coordinates
+// of mouse events; the view transform of the design area maps them to the
+// screen when painting
+class ComponentLabel : public QObject
 {
     friend class ChangeComponentPropertyCommand;
 
     Q_OBJECT
   public:
-    explicit ComponentLabel(COMPONENT comp_type, int resource_idx, double scale,
-                            QUndoStack *stack, QWidget *parent = nullptr);
+    // view: view transform of the design area, applied when painting
+    explicit ComponentLabel(COMPONENT comp_type, int resource_idx,
+                            const QTransform &view, QUndoStack *stack,
+                            QWidget *parent = nullptr);
+    // label for an existing component model, which the label then owns
+    explicit ComponentLabel(COMPONENT comp_type, int resource_idx,
+                            model::component::Component *component_model,
+                            const QTransform &view, QUndoStack *stack,
+                            QWidget *parent = nullptr);
     ~ComponentLabel();
 
     COMPONENT comp_type() const;
 
     model::component::Component *component_model() const;
 
+    // native geometry
+    int          x() const;
+    int          y() const;
+    int          width() const;
+    int          height() const;
+    QPoint       pos() const;
+    const QRect &geometry() const;
+    // geometry on the screen, under the current view transform
+    QRect viewGeometry() const;
+
+    // components connected later are drawn on top of earlier ones
+    unsigned long stackingOrder() const;
+    void          setStackingOrder(unsigned long order);
+
+    void show();
+    void hide();
+    bool isHidden() const;
+
+    void paint(QPainter &painter) const;
+    // draws component as a box, colored by its state during simulation
+    void paintLowDetail(QPainter &painter) const;
+
     void showBorder();
     void hideBorder();
 
     int     resourceIdx() const;
     QString params() const;
 
-    const std::vector<Wire *>              inputWires() const;
-    const std::vector<std::vector<Wire *>> outputWires() const;
-
-    // returns pre-transformation coordinates
-    QPoint getNativeCoordinates(double inverse_scale_factor,
-                                double inverse_translation_x,
-                                double inverse_translation_y);
+    const std::vector<Wire *> inputWires() const;
+    const std::vector<Net>   &outputNets() const;
 
     // keep wire connected to this component
     // is_input: whether wire is input connection
     // idx: index of input/output on component
     bool saveWire(Wire *wire, bool is_input, int idx);
     void removeWire(Wire *wire, bool is_input, int idx);
+    // same, without changing the component model, for connections it already
+    // has (or keeps)
+    bool keepWire(Wire *wire, bool is_input, int idx);
+    void dropWire(Wire *wire, bool is_input, int idx);
+    // gives up ownership of the component model, which is then not deleted
+    // along with the label
+    // wires must have been dropped first
+    model::component::Component *releaseModel();
     // update wire positions based on current position
     void moveWires();
 
     void removeFromCircuit();
     void bringBackToCircuit();
 
-    model::State getValue(int output_idx);
+    model::State getValue(const model::sim::Snapshot &snapshot,
+                          int                         output_idx) const;
+    // sets offset of component model evaluations in simulation snapshots
+    void setSnapshotSlot(size_t slot);
+    // recolors wires of output nets whose state changed in snapshot
+    // only wires intersecting live_area (native) are recolored; the rest are
+    // recolored when they enter it
+    void evaluateNets(const model::sim::Snapshot &snapshot,
+                      const QRect                &live_area);
 
     void mouseMoveEvent(QMouseEvent *ev);
     void mousePressEvent(QMouseEvent *ev);
     void mouseReleaseEvent(QMouseEvent *ev);
     void mouseDoubleClickEvent(QMouseEvent *ev);
+    void contextMenuEvent(QContextMenuEvent *ev);
 
     void move(int pos_x, int pos_y);
 
+    // writes the line of a component in a circuit file
+    static void writeRecord(std::ostream                      &file,
+                            const model::component::Component &component,
+                            const std::string &params, int x, int y);
+
   protected:
     int       _resource_idx = 0;
     COMPONENT _comp_type;
     // input wires: 1 wire per input
     std::vector<Wire *> _input_wires;
-    // output wires: many wires per output
-    std::vector<std::vector<Wire *>> _output_wires;
+    // output nets: many wires per output
+    std::vector<Net> _output_nets;
 
     // initial position of mouse press
     // used for keeping movement relative to initial mouse press when selected
-    int     _press_x, _press_y;
-    TOOL    _current_tool = TOOL::INSERT;
-    QLabel *_border;
+    int  _press_x, _press_y;
+    TOOL _current_tool = TOOL::INSERT;
+
+    // widget the component is drawn on, and its view transform
+    QWidget          *_design_area;
+    const QTransform *_view;
+    QRect             _geometry;
+    unsigned long     _stacking_order = 0;
+    // hidden until shown, like a child widget
+    bool _hidden         = true;
+    bool _border_visible = false;
+
+    // schedules a repaint of the component, if visible
+    void _update() const;
 
     Properties *_properties_popup = nullptr;
 
+    // first evaluation in the last simulation snapshot (ZERO outside of
+    // simulation), shown in low detail
+    model::State _state = model::State::ZERO;
+    void         _evaluateState(const model::sim::Snapshot &snapshot);
+    // mask of lit (not ZERO) evaluations of a 7 segment display in snapshot,
+    // with evaluation 0, the dot, as the highest bit and evaluation i as bit
+    // i - 1
+    unsigned int _litSegments(const model::sim::Snapshot &snapshot) const;
+
     // used before simulation start, to keep current parameters
     std::string _base_params;
     int         _base_resource_idx;
 
     // Component Model
     model::component::Component *_component_model;
+    size_t                       _snapshot_slot = 0;
 
     void _setupProperties();
+    // popup to enter a pattern for all evaluations of the component
+    // run_until: whether to run until the pattern, instead of breaking on it
+    void _setupPatternWatchpoint(bool run_until);
 
     QUndoStack *_undo_stack;
 
     ChangeComponentPropertyCommand *_property_command = nullptr;
 
-    double _scale;
-
-    // extra space outside component rectangle to consider for wire snap
-    static constexpr int WIRE_SNAP_LEEWAY = 15;
-
     bool _cancel_move = false;
 
     // flag to avoid move during simulation, if it resulted from click on
@@ -121,23 +201,21 @@ class ComponentLabel : public QLabel
     void setParams(QString params);
     // triggered by changeMode of DesignArea
     void changeMode(TOOL tool);
-    // triggered by rangeQuery of DesignArea
+    // called by DesignArea for components near a completed selection area
     void checkRangeQuery(int min_x, int min_y, int max_x, int max_y);
-    // triggered by wireSnap of DesignArea
-    void wireSnap(ComponentLabel *wire_source, int x, int y);
+    // called by DesignArea for components near the destination of a wire
+    // being created
+    // leeway: extra space around component to snap from, in native units
+    void wireSnap(ComponentLabel *wire_source, int x, int y, int leeway);
     // triggered by evaluate of DesignArea
-    void evaluate();
+    void evaluate(const model::sim::Snapshot &snapshot);
     // triggered by resetResource of DesignArea
-    void resetResource();
-    // triggered by writeComponent of DesignArea
-    void writeComponent(std::ofstream &file, double inverse_scale_factor,
-                        double inverse_translation_x,
-                        double inverse_translation_y);
-    // triggered by transformPosition of DesignArea
-    void positionTransformationApplied(int dx, int dy);
-    // triggered by transformScale of DesignArea
-    void scaleTransformationApplied(double size_scale, double pos_scale,
-                                    double offset_x, double offset_y);
+    void resetResource(const model::sim::Snapshot &snapshot);
+    // triggered by resetWireResource of DesignArea
+    // recolors wires of all output nets
+    void resetNets(const model::sim::Snapshot &snapshot);
+    // called by DesignArea when writing to file
+    void writeComponent(std::ostream &file);
     // triggered by cancelMove of DesignArea
     void cancelMove(ComponentLabel *component);
 
@@ -150,6 +228,9 @@ class ComponentLabel : public QLabel
     void moved(int dx, int dy);
     // emitted when mouse click is released after move
     void moveFinished();
+    // emitted when the component's position changes, to keep the spatial
+    // index of DesignArea up to date
+    void positionChanged(ComponentLabel *component);
     // emitted when a mouse press registers on component during wire mode
     void wireSource(ComponentLabel *component, int dx, int dy);
     // emitted when a wire being created is moved
@@ -161,6 +242,15 @@ class ComponentLabel : public QLabel
     void wireReleased();
     // emitted when a property value is changed
     void performPropertyUndoAction();
+    // emitted when a watchpoint is set on the component during simulation
+    void watchpointRequested(model::watch::Watchpoint watchpoint);
+    // emitted when watchpoints on the component are cleared during simulation
+    void watchpointsCleared(ComponentLabel *component);
+    // emitted to fast-forward the simulation until condition fires
+    void runUntilRequested(model::watch::Watchpoint condition);
+    // emitted when an input component is interacted with during simulation
+    // the component model is changed by the simulation runner
+    void simulationInput(model::sim::InputEvent event);
 };
 }
 }
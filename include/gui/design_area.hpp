@@ -2,27 +2,40 @@
 #define LOGICSIM_GUI_DESIGN_AREA_HPP
 
 #include <QApplication>
+#include <QContextMenuEvent>
 #include <QCursor>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
 #include <QSettings>
 #include <QStatusBar>
 #include <QString>
 #include <QTimer>
+#include <QTransform>
 #include <QUndoStack>
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "gui/component_label.hpp"
 #include "gui/resource_loader.hpp"
+#include "gui/spatial_grid.hpp"
 
+#include "model/binary_file.hpp"
 #include "model/circuit.hpp"
+#include "model/circuit_file.hpp"
 #include "model/component.hpp"
+#include "model/runner.hpp"
 
 namespace logicsim
 {
@@ -58,6 +71,9 @@ class DesignArea : public QWidget
     void mouseMoveEvent(QMouseEvent *ev);
     void mouseDoubleClickEvent(QMouseEvent *ev);
     void wheelEvent(QWheelEvent *ev);
+    void contextMenuEvent(QContextMenuEvent *ev);
+    void paintEvent(QPaintEvent *ev);
+    void resizeEvent(QResizeEvent *ev);
 
     TOOL mode() const;
     bool setMode(TOOL tool, COMPONENT comp_type = COMPONENT::NONE,
@@ -65,6 +81,11 @@ class DesignArea : public QWidget
     void stopSimulationMode();
     void pauseSimulation();
     void stepSimulation();
+    // performs ticks ticks in the background while paused, reporting progress
+    // in the status bar
+    void runTicks(std::uint64_t ticks);
+    // cancels ticks not yet performed by stepSimulation and runTicks
+    void cancelSteps();
     void continueSimulation();
     void resetSimulation();
 
@@ -72,6 +93,14 @@ class DesignArea : public QWidget
 
     unsigned int frequency() const;
     void         setFrequency(unsigned int freq);
+    // whether the simulation runs as fast as possible, instead of at the set
+    // frequency
+    bool maxSpeed() const;
+    void setMaxSpeed(bool max_speed);
+    // seed of random components, saved with the circuit so that simulations
+    // can be reproduced
+    std::uint64_t seed() const;
+    void          setSeed(std::uint64_t seed);
 
     // called when tab changes from/to this
     void pauseState();
@@ -118,20 +147,46 @@ class DesignArea : public QWidget
     COMPONENT _insert_component;
     int       _insert_resource_idx;
 
-    // vector of pointers to all components
-    // used to move view to next component
+    // vector of pointers to all connected labels
     std::vector<ComponentLabel *> _components;
+    // index in the circuit model of the component last moved to
     int                           _component_idx = 0;
+    // wires connected in the circuit
+    std::unordered_set<Wire *> _wires;
+
+    // stacking order of the last connected component
+    unsigned long _stacking_order = 0;
+
+    // components and wires by native position, so position queries (painting,
+    // range selection, wire snap, wire proximity) only visit nearby items
+    // native positions don't change with pan and zoom, so only moving,
+    // inserting and deleting items updates the index
+    SpatialGrid<ComponentLabel *> _component_index;
+    SpatialGrid<Wire *>           _wire_index;
+    // updates index entries of component and its wires
+    void _indexComponent(ComponentLabel *label);
+    // returns items whose native rectangle may intersect given native
+    // rectangle
+    std::vector<ComponentLabel *> _componentsNear(const QRect &rect) const;
+    std::vector<Wire *>           _wiresNear(const QRect &rect) const;
+
+    // topmost visible component at given position, or nullptr
+    ComponentLabel *_componentAt(const QPoint &pos) const;
+    // delivers mouse event to component, in its local native coordinates
+    // returns whether the component accepted it
+    bool _forwardMouseEvent(ComponentLabel *component, QMouseEvent *ev);
+    // component that accepted the last mouse press; receives mouse events
+    // until the button is released, like a widget would
+    ComponentLabel *_mouse_grabber = nullptr;
 
     // vector of selected components
     std::vector<ComponentLabel *> _selected_components;
 
     // initial selection point for selection border
     int _select_x, _select_y;
-    // labels for selection lines
-    // in order, array holds two vertical (left to right),
-    // then two horizontal (top to bottom)
-    QLabel *_selection_border[4] = { nullptr };
+    // selection border, drawn while selecting
+    bool  _selecting = false;
+    QRect _selection_rect;
 
     // current wire being drawn
     Wire *_wire = nullptr;
@@ -145,14 +200,136 @@ class DesignArea : public QWidget
 
     // positions to snap destination to
     // wire snaps to closest
-    WireSnapPosition              _wire_snap_closest;
+    WireSnapPosition              _wire_snap_closest = { nullptr, 0, 0 };
     std::vector<WireSnapPosition> _wire_snap_positions;
 
     // Circuit model
     model::circuit::Circuit _circuit_model;
-
-    unsigned int _freq  = 100;
-    QTimer      *_timer = nullptr;
+    // runs the circuit model on a worker thread during simulation
+    model::sim::Runner *_runner = nullptr;
+    // number of watchpoint triggers already reported
+    unsigned int _n_triggers = 0;
+    // labels of the runner's components, in the same order (nullptr for
+    // records without a label)
+    // only labels (and wires) of components whose evaluations changed are
+    // updated on each frame
+    std::vector<ComponentLabel *> _simulated_labels;
+
+    unsigned int  _freq      = 100;
+    bool          _max_speed = false;
+    std::uint64_t _seed;
+    // sets seed of the circuit model, through the runner if simulating
+    void          _setSeed(std::uint64_t seed);
+    // frequency to give to the runner
+    unsigned int _runnerFrequency() const;
+    // formats ticks label, along with achieved and requested tick rate while
+    // running
+    void _setTicksLabel(const model::sim::Snapshot &snapshot);
+    // e.g. 1.25 MHz
+    static QString _formatFrequency(double freq);
+    // redraws simulation state, once per frame
+    // stopped while the circuit is settled, since nothing changes until an
+    // input does
+    QTimer *_timer = nullptr;
+    // interval of _timer in ms
+    static const int FRAME_INTERVAL = 16;
+    // restarts _timer after the runner is woken up
+    void _resumeUpdates();
+    // ticks requested by the current run of steps, or 0 if not stepping
+    std::uint64_t _steps_requested = 0;
+    // shows progress of the current run of steps, once per frame
+    void          _showStepProgress();
+    // while running until a condition, the view is only refreshed once the
+    // condition fires or the tick limit is reached
+    bool          _running_until    = false;
+    unsigned int  _until_watchpoint = 0;
+    // tick limit last given to runUntil
+    std::uint64_t _until_limit      = 1000000000;
+    void          _startRunUntil(const model::watch::Watchpoint &condition,
+                                 std::uint64_t                   max_ticks);
+    // removes the condition, refreshes the view and reports the outcome
+    void          _endRunUntil();
+    // number of changed components above which a frame repaints the whole
+    // area
+    static const size_t FULL_UPDATE_THRESHOLD = 256;
+
+    // native area around the view, in which components and wires follow the
+    // simulation on each frame
+    // items outside it keep their last appearance until they enter it, so the
+    // work per frame depends on the view, not the size of the circuit
+    QRect            _live_area;
+    // extra space around the view included in the live area, in view pixels
+    static const int LIVE_AREA_MARGIN = 64;
+    // recomputes the live area after the view changes, creates and destroys
+    // labels and wires of loaded records, and brings items that entered it up
+    // to date with the simulation
+    void             _updateLiveArea();
+
+    /* Loaded records
+     * Components read from a file start out as plain records: their models
+     * are created and connected in the circuit, but their labels, and the
+     * wires between them, are only created once they enter the live area,
+     * and destroyed once they leave it, so only the records and models grow
+     * with the circuit, and the labels and wires with the view
+     * Labels the user interacts with (selected, clicked, wired) are pinned,
+     * along with all of their wires and the components at the other end of
+     * those, so edits and undo commands only ever refer to labels that are
+     * kept from then on
+     * A dormant record owns its model; a label created for it owns it until
+     * the label is destroyed
+     */
+    struct ComponentRecord
+    {
+        COMPONENT                    comp_type;
+        int                          res_idx;
+        QRect                        geometry;
+        unsigned long                stacking_order;
+        model::component::Component *model;
+        // label, while created
+        ComponentLabel              *label  = nullptr;
+        // whether the label is kept once created
+        bool                         pinned = false;
+        // whether all of its wires have been created (implies pinned)
+        bool                         wired  = false;
+        // wire records the component is an end of
+        std::vector<size_t>          wires;
+        // index of the component in the runner, while simulating
+        size_t                       simulated_idx = 0;
+    };
+    struct WireRecord
+    {
+        // component records at both ends, and output and input indices
+        size_t source, dest;
+        int    out, in;
+        QRect  bounds;
+        // wire, while created
+        Wire  *wire = nullptr;
+    };
+    std::vector<ComponentRecord> _records;
+    std::vector<WireRecord>      _wire_records;
+    // dormant records (without label or wire) by native position
+    SpatialGrid<size_t>          _record_index;
+    SpatialGrid<size_t>          _wire_record_index;
+    // record of each label created for a record
+    std::unordered_map<ComponentLabel *, size_t> _label_records;
+    // records whose labels may be destroyed once they leave the live area
+    // pinned records are dropped from it lazily
+    std::vector<size_t>                          _unpinned_records;
+
+    // native area covered by a wire record, as it would be by its wire
+    QRect           _wireRecordBounds(const WireRecord &wire_record) const;
+    // creates the label of a record, if dormant, and returns it
+    ComponentLabel *_createRecordLabel(size_t record_idx);
+    // creates the wire of a record, along with the labels at its ends
+    void            _createRecordWire(size_t wire_record_idx);
+    // destroys the label of a record and its wires, leaving the component
+    // model in the circuit
+    void            _destroyRecordLabel(size_t record_idx);
+    // whether the label of a record, or any of its wires, is in the live area
+    bool            _recordInLiveArea(size_t record_idx) const;
+    // keeps the label of a record from then on, with all of its wires
+    // no-op for labels not created for a record
+    void            _pin(ComponentLabel *label);
 
     QStatusBar *_status_bar;
     QLabel     *_ticks_label;
@@ -167,8 +344,10 @@ class DesignArea : public QWidget
 
     void _connectComponent(ComponentLabel *label, bool first_time = false);
     void _disconnectComponent(ComponentLabel *label);
-    void _deleteComponents(
-      std::unordered_map<std::string, ComponentLabel *> components);
+    // connect or disconnect label, leaving its component model as it is in
+    // the circuit
+    void _connectLabel(ComponentLabel *label, bool first_time);
+    void _disconnectLabel(ComponentLabel *label);
 
     void _connectWire(Wire *wire, bool first_time = true);
     void _disconnectWire(Wire *wire);
@@ -185,95 +364,45 @@ class DesignArea : public QWidget
 
     bool _color_wires = false;
 
-    /* Transformations
-     * Keeps information about current translation/scale transform
-     * Each component has a native position, as well as a transformed position
-     * The transformed position, which is the actual screen position of the
-     * component, is what is saved
-     * There are two types of transformations:
-     *
-     * 1) Position transformations
-     *  These consist of simple translations
-     *  To calculate, multiply each point by a 2D transformation matrix (to the
-     *  left), of type:
-     *  | 1  0  tx |
-     *  | 0  1  ty | * P
+    /* View transform
+     * Components and wires keep their native positions, which only change
+     * when they are moved; panning and zooming only change the view transform
+     * that maps native coordinates to the screen, and repaint
+     * The transform is a scale followed by a translation:
+     *  | s  0  tx |
+     *  | 0  s  ty | * P
      *  | 0  0   1 |
-     *  where tx, ty are the offsets to move by
+     * where s is deduced from the base zoom level and the current zoom level
+     *
+     * Panning by (dx, dy) adds dx, dy to tx, ty
      *
-     * 2) Zoom transformations
-     *  These consist of zooming around a certain point of origin (ox, oy)
-     *  To apply such a transformation, there are three steps:
-     *  * Move the point (ox, oy) to the native origin (0, 0)
-     *  * Apply a scale transformation
-     *  * Move the origin point back to its original location (ox, oy)
-     *  To calculate, multiply each point by the 2D transformation matrix for
-     *  the first translation, followed by the one for scaling, followed by the
-     *  one for the second translation:
-     *  | 1  0  ox |   | s  0  0 |   | 1  0  -ox |
-     *  | 0  1  oy | * | 0  s  0 | * | 0  1  -oy | * P
+     * Zooming around a point of origin (ox, oy) by a factor of f consists of
+     * moving (ox, oy) to the origin, scaling and moving it back, all applied
+     * after the current transform (multiplied from the left):
+     *  | 1  0  ox |   | f  0  0 |   | 1  0  -ox |
+     *  | 0  1  oy | * | 0  f  0 | * | 0  1  -oy |
      *  | 0  0   1 |   | 0  0  1 |   | 0  0    1 |
-     *  Notice that the order is from right to left, such that we multiply first
-     *  by the rightmost matrix (move to native origin), scale next and,
-     *  finally, bring origin back to original position
-     *  Because order of multiplication does not matter, this is equivalent to
-     *  the following:
-     *  | s  0  -s*ox+ox |
-     *  | 0  s  -s*oy+oy | * P
-     *  | 0  0         1 |
+     * which results in s' = f*s, tx' = f*tx - f*ox + ox, ty' = f*ty - f*oy + oy
      *
      * In this representation, each 2D point P is of the following type:
      *     | x |
      * P = | y |
      *     | 1 |
-     */
-
-    /* Transformation struct
-     * Keeps information about current transformation state
-     * Data:
-     *  * tx, ty: The current translation values of the transformation matrix:
-     *  | s  0  tx |
-     *  | 0  s  ty |
-     *  | 0  0   1 |
-     *  Which can be used to transform any native point into the current view's
-     *  coordinates
-     *  * tx_inv, ty_inv: The values of the inverse transformation matrix:
-     *  | s  0  tx_inv |
-     *  | 0  s  ty_inv |
-     *  | 0  0       1 |
-     *  Which can be used to transform any of the current view's points into
-     *  native coordinates
-     * Information about scale is unnecessary, since we can deduce it from the
-     * base zoom level and the current zoom level
      *
-     * Uses:
-     * 1) The forward transformation values are not used to perform
-     * transformations directly, since components keep their transformed
-     * positions
-     * As such, whenever a new transformation must be made, we simply
-     * multiply from the left with the appropriate matrix
-     * However, when using undo on a move action for component(s), it is
-     * necessary to save initial and final coordinates as native, because the
-     * view might be moved before redo is performed
-     * Therefore, on redo, we need to forward transform those native coordinates
-     * back to the view's coordinates, thus requiring tx and ty
-     * 2) The inverse transformation values are used to return to native
-     * coordinates
-     * This is useful when saving to a file, where we need to save
-     * native coordinates
-     * It is also used to save native coordinates when performing undo on a
-     * move action
+     * Components and wires keep a reference to _view and apply it when
+     * painting; the inverse maps mouse positions to native coordinates
      */
-    struct Transformation
-    {
-        double tx     = 0.0;
-        double ty     = 0.0;
-        double tx_inv = 0.0;
-        double ty_inv = 0.0;
-    } _transformation;
-
-    std::pair<int, int> _toNativeCoordinates(int x, int y);
-    std::pair<int, int> _toViewCoordinates(int x, int y);
+    QTransform _view;
+    QTransform _inv_view;
+    // sets view transform to the current scale and given translation
+    void _setView(double tx, double ty);
+
+    std::pair<int, int> _toNativeCoordinates(int x, int y) const;
+    // native rectangle covering given view rectangle
+    QRect               _toNativeRect(const QRect &rect) const;
+    // view geometries are rounded from native ones, so native rectangles are
+    // given some leeway
+    static const int    NATIVE_RECT_LEEWAY = 2;
 
     int _init_move_x, _init_move_y;
 
@@ -281,18 +410,26 @@ class DesignArea : public QWidget
     const double BASE_ZOOM_LEVEL       = 5;
     const double BASE_SCALE_FACTOR     = 1.2;
     const double INV_BASE_SCALE_FACTOR = 1 / BASE_SCALE_FACTOR;
+    const int    MIN_ZOOM_LEVEL        = -3;
+    const int    MAX_ZOOM_LEVEL        = 15;
 
     void _zoom(int origin_x, int origin_y, int new_zoom_level);
 
-    // moves view to component indicated by _current_component
+    // below this zoom level, components are drawn as boxes colored by their
+    // state and wires as single lines, since details aren't visible anyway
+    const int LOW_DETAIL_ZOOM_LEVEL = 2;
+    bool      _lowDetail() const;
+
+    // moves view to component indicated by _component_idx
     void _moveToComponent();
 
-    /* Signals and slots often transmit position information
+    /* Signals and slots often transmit position information, in native
+     * coordinates
      * Such information is referred to as global, if its frame of reference
-     * is the origin point of DesignArea; in that case, it is denoted (x, y)
+     * is the native origin; in that case, it is denoted (x, y)
      * Such information is referred to as relative, if its frame of reference
-     * is the origin point of a different widget (usually a ComponentLabel);
-     * in that case, it is denoted as (dx, dy)
+     * is the position of a ComponentLabel; in that case, it is denoted as
+     * (dx, dy)
      */
   protected slots:
     // Design Slots
@@ -309,6 +446,9 @@ class DesignArea : public QWidget
     // triggered by moveFinished of ComponentLabel
     // adds move to undo stack
     void finishMove();
+    // triggered by positionChanged of ComponentLabel
+    // updates spatial index
+    void componentPositionChanged(ComponentLabel *component);
     // triggered by wireSource of ComponentLabel
     // sets component as source of wire, with source position dx,dy
     void getWireSource(ComponentLabel *component, int dx, int dy);
@@ -326,53 +466,44 @@ class DesignArea : public QWidget
     void propertyUndoActionPerformed();
     // triggered by proximityConfirmed of Wire
     void getProximityWireDistance(Wire *wire, int distance);
+    // triggered by watchpointRequested of ComponentLabel
+    void addWatchpoint(model::watch::Watchpoint watchpoint);
+    // triggered by watchpointsCleared of ComponentLabel
+    void clearWatchpoints(ComponentLabel *component);
+    // triggered by runUntilRequested of ComponentLabel
+    // asks for a tick limit, then runs as fast as possible until condition
+    // fires
+    void runUntil(model::watch::Watchpoint condition);
+    // triggered by simulationInput of ComponentLabel
+    // event tick is set to the currently displayed tick
+    void postInput(model::sim::InputEvent event);
 
     // Simulation
     // triggered by timer
-    void executeTick(unsigned int ticks = 1);
+    // shows latest simulation state published by the runner
+    void updateSimulation();
 
   signals:
     // emitted when the mode is changed
     void modeChanged(TOOL tool);
-    // emitted when a selection area is completed, to find components inside it
-    void rangeQuery(int x_min, int y_min, int x_max, int y_max);
-    // emitted during wire creation, when destination is moved
-    // used to find components whose inputs/outputs are close to wire
-    // destination for snapping
-    void wireSnap(ComponentLabel *wire_source, int x, int y);
-    // emitted during simulation, after every tick
-    // components receiving this signal will evaluate based on their component
-    // model
-    void evaluate();
     // emitted for components when simulation is reset
-    void resetResource();
-    // emitted for wires when simulation is reset (only when colored wires is
-    // enabled)
-    void resetWireResource();
-    // emitted when writing to file
-    void writeComponent(std::ofstream &file, double inverse_scale_factor,
-                        double inverse_translation_x,
-                        double inverse_translation_y) const;
+    void resetResource(const model::sim::Snapshot &snapshot);
+    // emitted for components to recolor the wires they drive, when simulation
+    // is reset (only when colored wires is enabled)
+    void resetWireResource(const model::sim::Snapshot &snapshot);
     // emitted when an undo action is redone/undone
     void newUndoActionPerformed(bool was_undo, bool undo_enabled,
                                 bool redo_enabled);
-    // emitted when mouse is moved during wire remove mode
-    void wireProximityCheck(int x, int y);
     // emitted when selections change, to update edit menu
     void newSelection(bool have_selected, bool have_clipboard);
-    // emitted during simulation, if color wires is enabled
-    void evaluateWire();
     // emitted to hide all colored wires if color wires is disabled during
     // simulation
     void disableColorWires();
-    // emitted when a move transformation is performed
-    void transformPosition(int dx, int dy);
-    // emitted when a zoom transformation is performed
-    void transformScale(double size_scale, double pos_scale, double offset_x,
-                        double offset_y);
     // emitted when a component is removed from the selection, so the component
     // doesn't emit moved signals
     void cancelMove(ComponentLabel *component);
+    // emitted when the simulation pauses itself, because a watchpoint fired
+    void simulationPaused();
 };
 }
 }
@@ -10,6 +10,8 @@
 #include <QSettings>
 #include <QString>
 
+#include <cstdint>
+
 #include "gui/doc_window.hpp"
 #include "gui/properties.hpp"
 #include "gui/resource_loader.hpp"
@@ -83,8 +85,11 @@ class MainWindow : public QMainWindow
     void enableContinue();
     void enablePause();
 
+    // asks for a number of ticks to run while paused
+    void runTicks();
     void simulationProperties();
-    void setSimulationFrequency(QString freq);
+    // group_idx: 0 for frequency, 1 for speed, 2 for seed
+    void setSimulationProperty(QString value, int group_idx);
 
     void setUndoActionState(bool undo_enabled, bool redo_enabled);
     void setSelectActionState(bool have_select, bool have_clipboard);
@@ -6,6 +6,8 @@
 #include <QPainter>
 #include <QPixmap>
 
+#include <algorithm>
+#include <array>
 #include <bitset>
 #include <functional>
 #include <iomanip>
@@ -215,6 +217,8 @@ inline const std::unordered_map<COMPONENT, QString>
 };
 
 inline const int WIRE_REMOVE_DISTANCE_THRESHOLD = 20;
+// extra space outside component rectangle to consider for wire snap
+inline const int WIRE_SNAP_LEEWAY = 15;
 
 inline const std::unordered_set<COMPONENT> reset_resource_on_sim_components = {
     LED, _7SEG_5IN, _7SEG_8IN
@@ -234,11 +238,29 @@ inline QString DOC_PATH;
 // initialized when load is called, because QPixmap cannot be created here
 inline std::unordered_map<COMPONENT, std::vector<QPixmap>> comp_images;
 
+// component images scaled for one zoom level, filled in as requested
+struct ScaledImages
+{
+    double                                              scale;
+    unsigned long                                       last_used;
+    std::unordered_map<COMPONENT, std::vector<QPixmap>> images;
+};
+
+// scaled images are kept for this many zoom levels, shared by all tabs
+// zooming to a new level drops the least recently used one
+inline const size_t              SCALED_IMAGES_LEVELS = 4;
+inline std::vector<ScaledImages> scaled_images;
+inline unsigned long             scaled_images_uses = 0;
+
 inline QPixmap *hselline, *vselline;
 inline QPixmap *hwire, *vwire;
 inline QPixmap *hwire_up, *hwire_down, *vwire_left, *vwire_right;
 inline QPixmap *hwire_on, *vwire_on;
 inline QPixmap *hwire_z, *vwire_z;
+// wires and selection lines are solid, so they are drawn as plain rectangles
+// in the colors of their resources
+inline QColor wire_colors[3];
+inline QColor line_color;
 
 inline QIcon *select_icon;
 inline QIcon *move_icon;
@@ -253,40 +275,29 @@ inline QIcon *pause_sim_icon;
 inline QIcon *step_sim_icon;
 inline QIcon *reset_sim_icon;
 
-inline const std::unordered_map<size_t, size_t> _7seg_5in_res_map = {
-    { 119,  1 },
-    {  65,  2 },
-    { 110,  3 },
-    { 107,  4 },
-    {  89,  5 },
-    {  59,  6 },
-    {  63,  7 },
-    {  97,  8 },
-    { 127,  9 },
-    { 123, 10 },
-    { 125, 11 },
-    {  31, 12 },
-    {  54, 13 },
-    {  79, 14 },
-    {  62, 15 },
-    {  60, 16 },
-    { 247, 17 },
-    { 193, 18 },
-    { 238, 19 },
-    { 235, 20 },
-    { 217, 21 },
-    { 187, 22 },
-    { 191, 23 },
-    { 225, 24 },
-    { 255, 25 },
-    { 251, 26 },
-    { 253, 27 },
-    { 159, 28 },
-    { 182, 29 },
-    { 207, 30 },
-    { 190, 31 },
-    { 188, 32 },
-};
+// resource index of the 5 input 7 segment display for each mask of lit (not
+// ZERO) evaluations, with evaluation 0, the dot, as the highest bit and
+// evaluation i as bit i - 1
+// masks that no input combination produces show the unlit display
+constexpr std::array<size_t, 256> make_7seg_5in_res_table()
+{
+    std::array<size_t, 256> table {};
+    for (unsigned int value = 0; value < 32; ++value)
+    {
+        std::uint16_t evals = model::output::_5in_7segment_table[value];
+        unsigned int  mask  = 0;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            mask |= (((evals >> (2 * i)) & 3) != model::State::ZERO)
+                    << ((7 + i) % 8);
+        }
+        table[mask] = value + 1;
+    }
+    return table;
+}
+
+constexpr std::array<size_t, 256> _7seg_5in_res_table =
+  make_7seg_5in_res_table();
 
 // ranges apply to both rows and columns, because keypad is symmetric
 inline const std::vector<std::pair<double, double>> keypad_rel_pos_range = {
@@ -448,11 +459,13 @@ const std::vector<std::pair<double, double>> &getComponentIOPositionVector(
 const std::pair<int, int> getComponentIORelativePos(ComponentLabel *component,
                                                     bool is_input, int idx);
 
+// native size of component image
+QSize   getComponentSize(COMPONENT comp_type, int res_idx);
+// returns cached image, scaling it on first use at each zoom level
 QPixmap getComponentResource(COMPONENT comp_type, int res_idx, double scale);
-QPixmap getBorder(int width, int height);
-QPixmap getLine(LINE_TYPE line_type, int size);
-QPixmap getWire(LINE_TYPE line_type, int size, double scale,
-                const model::State &wire_type = model::State::ZERO);
+void    clearComponentResourceCache();
+QColor  getWireColor(const model::State &wire_type = model::State::ZERO);
+QColor  getLineColor();
 QPixmap getWireMarking(LINE_TYPE line_type, int size, double scale,
                        bool dir_ul = true);
 void    load();
@@ -0,0 +1,185 @@
+#ifndef LOGICSIM_GUI_SPATIAL_GRID_HPP
+#define LOGICSIM_GUI_SPATIAL_GRID_HPP
+
+#include <QRect>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace logicsim
+{
+namespace gui
+{
+// uniform grid of square cells, used to find the items (components, wires)
+// near a position without visiting all of them
+// each item is kept in every cell its rectangle touches
+template <typename T> class SpatialGrid
+{
+  public:
+    // adds item with given rectangle, or updates its rectangle if present
+    void insert(T item, const QRect &rect)
+    {
+        CellRange range = _cellRange(rect);
+        auto      it    = _items.find(item);
+        if (it != _items.end())
+        {
+            if (it->second == range)
+            {
+                return;
+            }
+            _removeFromCells(item, it->second);
+            it->second = range;
+        }
+        else
+        {
+            _items.emplace(item, range);
+        }
+
+        for (int cy = range.min_y; cy <= range.max_y; ++cy)
+        {
+            for (int cx = range.min_x; cx <= range.max_x; ++cx)
+            {
+                _cells[_key(cx, cy)].push_back(item);
+            }
+        }
+    }
+
+    void remove(T item)
+    {
+        auto it = _items.find(item);
+        if (it == _items.end())
+        {
+            return;
+        }
+        _removeFromCells(item, it->second);
+        _items.erase(it);
+    }
+
+    // appends items whose rectangles may intersect rect, once each
+    // items must still be checked by the caller
+    void query(const QRect &rect, std::vector<T> &items) const
+    {
+        CellRange range = _cellRange(rect);
+
+        auto visit = [this, &range, &items](int cx, int cy,
+                                            const std::vector<T> &cell)
+        {
+            for (const auto &item : cell)
+            {
+                // items spanning several cells are only reported from the
+                // first cell they share with the query
+                const CellRange &item_range = _items.at(item);
+                if (cx == std::max(item_range.min_x, range.min_x) &&
+                    cy == std::max(item_range.min_y, range.min_y))
+                {
+                    items.push_back(item);
+                }
+            }
+        };
+
+        // large queries (e.g. selecting everything when zoomed out) go
+        // through the occupied cells instead
+        if (static_cast<size_t>(range.max_x - range.min_x + 1) *
+              (range.max_y - range.min_y + 1) >
+            _cells.size())
+        {
+            for (const auto &[key, cell] : _cells)
+            {
+                int cx = static_cast<int32_t>(key >> 32);
+                int cy = static_cast<int32_t>(key & 0xFFFFFFFF);
+                if (range.min_x <= cx && cx <= range.max_x &&
+                    range.min_y <= cy && cy <= range.max_y)
+                {
+                    visit(cx, cy, cell);
+                }
+            }
+            return;
+        }
+
+        for (int cy = range.min_y; cy <= range.max_y; ++cy)
+        {
+            for (int cx = range.min_x; cx <= range.max_x; ++cx)
+            {
+                auto cell = _cells.find(_key(cx, cy));
+                if (cell != _cells.end())
+                {
+                    visit(cx, cy, cell->second);
+                }
+            }
+        }
+    }
+
+    void clear()
+    {
+        _cells.clear();
+        _items.clear();
+    }
+
+  protected:
+    // side of each cell, in native coordinates
+    static constexpr int CELL_SIZE = 128;
+
+    // inclusive range of cells covered by a rectangle
+    struct CellRange
+    {
+        int min_x, min_y, max_x, max_y;
+
+        bool operator==(const CellRange &other) const
+        {
+            return min_x == other.min_x && min_y == other.min_y &&
+                   max_x == other.max_x && max_y == other.max_y;
+        }
+    };
+
+    std::unordered_map<uint64_t, std::vector<T>> _cells;
+    std::unordered_map<T, CellRange>             _items;
+
+    static int _cell(int coord)
+    {
+        // rounds towards negative infinity
+        return coord >= 0 ? coord / CELL_SIZE : (coord + 1) / CELL_SIZE - 1;
+    }
+
+    static CellRange _cellRange(const QRect &rect)
+    {
+        // empty rectangles still occupy the cell of their top left point
+        return { _cell(rect.left()),
+                 _cell(rect.top()),
+                 _cell(std::max(rect.left(), rect.right())),
+                 _cell(std::max(rect.top(), rect.bottom())) };
+    }
+
+    static uint64_t _key(int cx, int cy)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+               static_cast<uint32_t>(cy);
+    }
+
+    void _removeFromCells(T item, const CellRange &range)
+    {
+        for (int cy = range.min_y; cy <= range.max_y; ++cy)
+        {
+            for (int cx = range.min_x; cx <= range.max_x; ++cx)
+            {
+                auto cell = _cells.find(_key(cx, cy));
+                if (cell == _cells.end())
+                {
+                    continue;
+                }
+                std::vector<T> &items = cell->second;
+                items.erase(std::remove(items.begin(), items.end(), item),
+                            items.end());
+                if (items.empty())
+                {
+                    _cells.erase(cell);
+                }
+            }
+        }
+    }
+};
+}
+}
+
+#endif // LOGICSIM_GUI_SPATIAL_GRID_HPP
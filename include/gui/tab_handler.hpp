@@ -91,6 +91,7 @@ class TabHandler : public QTabWidget
     void stopSimulationMode();
     void pauseSimulation();
     void stepSimulation();
+    void cancelSteps();
     void continueSimulation();
     void resetSimulation();
 
@@ -112,6 +113,8 @@ class TabHandler : public QTabWidget
     // signal to inform main window of undo/redo actions, to update edit menu
     void undoActionPerformed(bool undo_enabled, bool redo_enabled);
     void selectionActionPerformed(bool have_select, bool have_clipboard);
+    // emitted when the simulation of the current tab pauses itself
+    void simulationPaused();
 };
 
 void setMouseTrackingRecursive(QWidget *widget, bool value);
@@ -3,6 +3,8 @@
 
 #include <QUndoCommand>
 
+#include <cstdint>
+
 #include "gui/component_label.hpp"
 #include "gui/design_area.hpp"
 #include "gui/wire.hpp"
@@ -113,15 +115,21 @@ class ChangeComponentPropertyCommand : public QUndoCommand
 class ChangeSimulationPropertiesCommand : public QUndoCommand
 {
   public:
-    ChangeSimulationPropertiesCommand(DesignArea *design_area, int prev_freq,
-                                      int freq);
+    ChangeSimulationPropertiesCommand(DesignArea   *design_area,
+                                      unsigned int  prev_freq,
+                                      bool          prev_max_speed,
+                                      std::uint64_t prev_seed,
+                                      unsigned int freq, bool max_speed,
+                                      std::uint64_t seed);
 
     void redo();
     void undo();
 
   protected:
-    DesignArea *_design_area;
-    int         _prev_freq, _freq;
+    DesignArea   *_design_area;
+    unsigned int  _prev_freq, _freq;
+    bool          _prev_max_speed, _max_speed;
+    std::uint64_t _prev_seed, _seed;
 };
 }
 }
@@ -1,14 +1,20 @@
 #ifndef LOGICSIM_GUI_WIRE_HPP
 #define LOGICSIM_GUI_WIRE_HPP
 
-#include <QLabel>
+#include <QObject>
+#include <QLine>
+#include <QPainter>
+#include <QRect>
+#include <QTransform>
 #include <QWidget>
 
 #include <limits>
+#include <vector>
 
 #include "gui/resource_loader.hpp"
 
 #include "model/component.hpp"
+#include "model/runner.hpp"
 
 namespace logicsim
 {
@@ -21,15 +27,18 @@ struct WireConnection
     ComponentLabel *component = nullptr;
     bool            is_input;
     int             idx; // index of input/output on component
-    int x, y; // global coordinates of wire node that connects to component
+    int x, y; // native coordinates of wire node that connects to component
 };
 
-class Wire : public QWidget
+// wire between an output and an input, as drawn on the design area
+// wires are not widgets; the design area (parent) paints them in batches
+// endpoints are native; segments are laid out on the screen when painting,
+// under the view transform of the design area
+class Wire : public QObject
 {
     Q_OBJECT
   public:
-    explicit Wire(double scale, QWidget *parent = nullptr);
-    ~Wire();
+    explicit Wire(const QTransform &view, QWidget *parent = nullptr);
 
     // sets source component, based on relative position of click (dx, dy)
     // must be called before setComponent2
@@ -44,7 +53,7 @@ class Wire : public QWidget
     // sets destination component based on given i/o index
     bool setComponent2(ComponentLabel *component, bool is_input, int io_idx);
 
-    // repositions wire based on given global destination coordinates (dest_x,
+    // repositions wire based on given native destination coordinates (dest_x,
     // dest_y) source coordinates are in _conns[0]
     void repositionDest(int dest_x, int dest_y);
     // saves this wire in the components it is connected to through _conns
@@ -52,11 +61,28 @@ class Wire : public QWidget
     // returns false if connection failed (both inputs/ouputs, already connected
     // input)
     bool saveInComponents();
+    // same, without changing the component models, for a connection they
+    // already have
+    bool keepInComponents();
     // repositions wire to current location
     void reposition();
 
     void hide();
     void show();
+    bool isHidden() const;
+
+    // native area covered by the wire's segments
+    QRect bounds() const;
+    // value carried by the wire, used for its color (ZERO unless colored)
+    model::State state() const;
+    // appends the wire's segments on the screen to rects, so wires of the
+    // same color can be drawn together
+    void  addSegments(std::vector<QRect> &rects) const;
+    // straight line between the wire's ends on the screen, drawn in place of
+    // its segments in low detail
+    QLine viewLine() const;
+    // draws deletion marking around the wire, if marked
+    void paintMarkings(QPainter &painter) const;
 
     // returns information about the component which is being driven
     // pair: {Component * of output component, index of output}
@@ -77,6 +103,8 @@ class Wire : public QWidget
     // wire's components)
     void removeFromOppositeComponent(ComponentLabel *component);
     void removeFromComponents();
+    // removes wire from its components, without changing the component models
+    void dropFromComponents();
 
     void markForDeletion();
     void unmarkForDeletion();
@@ -94,55 +122,62 @@ class Wire : public QWidget
   protected:
     TOOL _current_tool = TOOL::WIRE;
 
-    // made up of 3 parts
-    QLabel *_hwire1 = nullptr;
-    QLabel *_vwire  = nullptr;
-    QLabel *_hwire2 = nullptr;
+    // widget the wire is drawn on, and its view transform
+    QWidget          *_design_area;
+    const QTransform *_view;
 
-    QLabel *_hwire1_on = nullptr;
-    QLabel *_vwire_on  = nullptr;
-    QLabel *_hwire2_on = nullptr;
+    model::State _state = model::State::ZERO;
 
-    QLabel *_hwire1_z = nullptr;
-    QLabel *_vwire_z  = nullptr;
-    QLabel *_hwire2_z = nullptr;
-
-    bool _wire_on = false;
-
-    // deletion marking
-    QLabel *_hwire1_up = nullptr, *_hwire1_down = nullptr;
-    QLabel *_vwire_left = nullptr, *_vwire_right = nullptr;
-    QLabel *_hwire2_up = nullptr, *_hwire2_down = nullptr;
+    bool _marked = false;
 
     WireConnection _conns[2];
 
     bool _setComponent(int idx, ComponentLabel *component, int dx, int dy);
     bool _setComponent(int idx, ComponentLabel *component, bool is_input,
                        int io_idx);
+    // until a destination is set, the wire ends at its source
+    void _startDestAtSource(int idx);
     void _updatePosition(int idx);
 
-    bool _updated_markings = false;
-
-    void _createColorWire();
+    // computes segments on the screen, made up of 3 parts: horizontal,
+    // vertical, horizontal
+    void _viewSegments(QRect segments[3]) const;
 
-    void _updateWireMarkings();
+    // scale of the wire's thickness on the screen
+    double _scale() const;
+    // thickness of deletion marking lines
+    int    _markingThickness() const;
+    // schedules a repaint of the area covered by the wire and its marking
+    void _update() const;
 
-    double       _scale;
     const double SCALE_SCALING_FACTOR = 1.2;
 
     bool _hidden = false;
 
   public slots:
-    void checkProximity(int x, int y);
+    // called by DesignArea for wires near the cursor during wire remove mode
+    // threshold: maximum distance from the cursor, in native units
+    void checkProximity(int x, int y, double threshold);
     void changeMode(TOOL tool);
-    void evaluate();
+    // reads state from the output driving the wire
+    void evaluate(const model::sim::Snapshot &snapshot);
+    // sets state, as read once for the wire's net
+    void setState(model::State state);
     void uncolor();
-    void scaleTransformationApplied(double size_scale);
-    void updateColorWire();
 
   signals:
     void proximityConfirmed(Wire *wire, int distance);
 };
+
+// wires driven by the same output of a component
+// the output is read once for all of them, and they are only recolored when
+// it changes
+struct Net
+{
+    std::vector<Wire *> wires;
+    // state of the output when the wires were last colored
+    model::State state = model::State::ZERO;
+};
 }
 }
 
@@ -0,0 +1,74 @@
+#ifndef LOGICSIM_MODEL_BINARY_FILE_HPP
+#define LOGICSIM_MODEL_BINARY_FILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "model/circuit_file.hpp"
+#include "model/mapped_data.hpp"
+#include "model/mapped_file.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+/* Binary circuit files (.lsb)
+ * Hold the same information as circuit files (.lsc), laid out so that a
+ * memory-mapped file can be used directly, without parsing any fields
+ * All values are 32-bit, so every section is 4-byte aligned, and in the byte
+ * order of the machine that wrote the file; the byte order mark rejects files
+ * written with the other one
+ *
+ * Header:
+ *  magic "LSCB", version, byte order mark 0x01020304, frequency,
+ *  n_ctypes, n_components, n_inputs, strings_size, seed (low, then high 32
+ *  bits; version 1 files end the header before it, and have seed 0)
+ * Sections, in order:
+ *  ctype_offsets[n_ctypes + 1]: type table, names of used component types
+ *  ctypes[n_components]: index of each component's type in the type table
+ *  coordinates[2 * n_components]: x, y of each component (signed)
+ *  id_offsets[n_components + 1]
+ *  param_offsets[n_components + 1]
+ *  input_offsets[n_components + 1]: range of each component's inputs
+ *  input_components[n_inputs]: index of driving component, or NULL_INPUT
+ *  input_outs[n_inputs]: index of driving output
+ *  strings[strings_size]: type names, ids and parameters, referred to by
+ *  the offset arrays (entries i and i + 1 delimit string i)
+ *
+ * Inputs refer to components by index, so they are already resolved
+ */
+
+constexpr char          BINARY_MAGIC[4]   = { 'L', 'S', 'C', 'B' };
+constexpr std::uint32_t BINARY_VERSION    = 2;
+constexpr std::uint32_t BINARY_BYTE_ORDER = 0x01020304;
+constexpr std::uint32_t NULL_INPUT = std::numeric_limits<std::uint32_t>::max();
+
+// whether filepath is a binary circuit file, based on its contents
+bool is_binary(const std::string &filepath);
+
+// reads a binary circuit file, which is memory-mapped
+// records refer to the mapped file, and inputs are already resolved
+// throws std::invalid_argument if the file is not a valid binary circuit file
+CircuitFile read_binary(const std::string &filepath);
+
+// writes circuit_file in binary format
+// throws std::invalid_argument if an input refers to a missing component
+void write_binary(const std::string &filepath, const CircuitFile &circuit_file);
+
+// reads a circuit file of either format
+CircuitFile read_any(const std::string &filepath, unsigned int n_threads = 0);
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_BINARY_FILE_HPP
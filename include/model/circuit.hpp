@@ -2,15 +2,21 @@
 #define LOGICSIM_MODEL_CIRCUIT_HPP
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "model/component.hpp"
 #include "model/mapped_data.hpp"
+#include "model/profiler.hpp"
+#include "model/watchpoint.hpp"
 
 #include "utils.hpp"
 
@@ -26,21 +32,117 @@ class Circuit
     ~Circuit();
 
     void add_component(component::Component &component);
+    // adds component, which is then deleted by the circuit
+    void own_component(component::Component &component);
     void remove_component(component::Component &component);
 
     void tick();
     void check() const;
     void reset();
 
-    unsigned int total_ticks() const;
+    // performs up to ticks ticks, stopping early after a tick on which a
+    // watchpoint fired
+    // returns number of ticks performed
+    std::uint64_t run(std::uint64_t ticks);
+    // performs ticks until condition fires, or max_ticks ticks are performed
+    // other watchpoints don't stop it
+    // returns whether condition fired
+    bool run_until(const watch::Watchpoint &condition,
+                   std::uint64_t            max_ticks);
 
-    bool empty() const;
+    std::uint64_t total_ticks() const;
+
+    // seed of random components, each of which draws its own sequence
+    // depending on the stream saved in its parameters
+    void          set_seed(std::uint64_t seed);
+    std::uint64_t seed() const;
+
+    // whether further ticks can't change anything until inputs are changed:
+    // no evaluation changed for longer than any component's delay, and no
+    // component changes on its own
+    bool settled() const;
+    // counts ticks as performed without performing them, e.g. while settled
+    void skip(std::uint64_t ticks);
+
+    bool   empty() const;
+    size_t size() const;
+    // components in the order they are ticked
+    const std::vector<component::Component *> &components() const;
+    // reserves space for n_components components
+    void reserve(size_t n_components);
+
+    // Watchpoints
+    // returns handle used to refer to the watchpoint
+    unsigned int add_watchpoint(const watch::Watchpoint &watchpoint);
+    void         remove_watchpoint(unsigned int handle);
+    // removes all watchpoints probing component
+    void remove_watchpoints(const component::Component &component);
+    void clear_watchpoints();
+
+    const watch::Watchpoint &watchpoint(unsigned int handle) const;
+    bool                     has_watchpoint(unsigned int handle) const;
+    // handles of watchpoints which fired on the last tick
+    const std::vector<unsigned int> &triggered_watchpoints() const;
+
+    // Profiling
+    // while enabled, ticks count evaluations and time per component type, and
+    // record their latency
+    // time per type is measured on one tick in PROFILE_SAMPLE_INTERVAL, and
+    // scaled to all ticks; latencies come from the other ticks, which are not
+    // slowed down by reading the clock per component
+    static const unsigned int PROFILE_SAMPLE_INTERVAL = 16;
+    // has no effect if built with LOGICSIM_NO_PROFILING defined
+    void                    set_profiling(bool enabled);
+    bool                    profiling() const;
+    const profile::Profile &profile() const;
+    void                    reset_profile();
 
   protected:
-    unsigned int                        _total_ticks = 0;
+    std::uint64_t                       _total_ticks = 0;
+    // consecutive ticks on which no evaluation changed
+    unsigned int                        _quiet_ticks = 0;
+    std::uint64_t                       _seed        = 0;
     std::vector<component::Component *> _components;
     std::unordered_set<unsigned int>    _component_ids;
 
+    // watched evaluation, shared by all watchpoints probing it
+    struct WatchedOutput
+    {
+        watch::Probe probe;
+        State        last;
+        // false until first checked after being added or reset, so that level
+        // conditions which already hold also fire
+        bool                      primed;
+        std::vector<unsigned int> watchpoints;
+    };
+
+    unsigned int                                       _next_watchpoint = 0;
+    std::unordered_map<unsigned int, watch::Watchpoint> _watchpoints;
+    std::vector<WatchedOutput>                         _watched;
+    std::vector<unsigned int>                          _triggered;
+    // watchpoints added since the last check
+    std::vector<unsigned int>                          _added_watchpoints;
+
+    void _rebuild_watched();
+    // only called when there are watchpoints
+    // conditions are checked only for outputs that changed
+    void _check_watchpoints();
+
+    bool             _profiling = false;
+    profile::Profile _profile;
+    // index of counters in _profile.ctypes for each component, or empty if
+    // components changed since last profiled tick
+    std::vector<unsigned int> _profile_slots;
+    // number of components of each used type, as (slot, count)
+    std::vector<std::pair<unsigned int, std::uint64_t>> _profile_counts;
+    // time taken by reading the clock, subtracted from each measured interval
+    std::uint64_t _clock_overhead = 0;
+
+    // tick with profiling enabled
+    void _profiled_tick();
+    // counts the tick just performed, given whether any evaluation changed
+    void _end_tick(bool changed);
+
     // Components created by this object, to be deleted in destructor
     std::vector<component::Component *> _created_components;
 };
@@ -0,0 +1,128 @@
+#ifndef LOGICSIM_MODEL_CIRCUIT_FILE_HPP
+#define LOGICSIM_MODEL_CIRCUIT_FILE_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "model/circuit.hpp"
+#include "model/component.hpp"
+#include "model/mapped_data.hpp"
+#include "model/mapped_file.hpp"
+
+#include "utils.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+/* Circuit files (.lsc)
+ * The first line holds the simulation frequency and the seed of random
+ * components, as frequency;seed (the seed is 0 if omitted)
+ * Every other line describes a component, as:
+ *  id;CTYPE;params;x,y;input_0,input_1,...
+ * where each input is either NULL (undriven) or id:out, the id of the driving
+ * component and the index of the driving output
+ * Coordinates are native (untransformed) design area coordinates
+ *
+ * Records refer to the file contents through string views, instead of copying
+ * each field; the contents are kept alive by CircuitFile::storage
+ */
+
+struct InputRecord
+{
+    bool             null;
+    std::string_view id;
+    unsigned int     out;
+};
+
+struct ComponentRecord
+{
+    std::string_view id;
+    std::string_view ctype;
+    std::string_view params;
+    int              x, y;
+    // index of ctype in model::ctypes
+    unsigned int ctype_idx;
+    // inputs are CircuitFile::inputs[inputs_begin, inputs_begin + n_inputs)
+    size_t       inputs_begin;
+    unsigned int n_inputs;
+    // line in file, for error messages
+    size_t line;
+};
+
+// input of a component, resolved to the index of its driving component in
+// CircuitFile::components
+struct ResolvedInput
+{
+    bool         null;
+    size_t       component_idx;
+    unsigned int out;
+};
+
+struct CircuitFile
+{
+    unsigned int                 frequency;
+    std::uint64_t                seed = 0;
+    std::vector<ComponentRecord> components;
+    // inputs of all components, in order
+    std::vector<InputRecord> inputs;
+    // inputs already resolved when reading the file (same indices as inputs),
+    // or empty if they must be resolved by id
+    std::vector<ResolvedInput> resolved_inputs;
+    // memory the records refer to
+    std::shared_ptr<const void> storage;
+};
+
+/* Large files are parsed, and their components created and connected, on
+ * n_threads threads (0: one per hardware thread, 1: no additional threads)
+ * Errors are the same as when using a single thread; if there are multiple,
+ * the one for the first line of the file is thrown
+ */
+
+// parses a circuit file, which is memory-mapped
+// throws std::invalid_argument on syntax errors
+CircuitFile read(const std::string &filepath, unsigned int n_threads = 0);
+// parses circuit file contents
+CircuitFile parse(std::string contents, unsigned int n_threads = 0);
+
+void write(const std::string &filepath, const CircuitFile &circuit_file);
+void write(std::ostream &stream, const CircuitFile &circuit_file);
+
+// parameters to give the component created for a record
+// random components saved before their stream was get one derived from the
+// record id, so that such files keep producing the same values
+std::string record_params(const ComponentRecord &record);
+
+// checks the inputs of every component record against the components
+// created for them (with the same index), and resolves them
+// returned inputs have the same indices as CircuitFile::inputs
+// throws std::invalid_argument for inputs referring to missing components or
+// outputs, and for missing or extra inputs
+std::vector<ResolvedInput>
+resolve_inputs(const CircuitFile                         &circuit_file,
+               const std::vector<component::Component *> &components,
+               unsigned int                               n_threads = 0);
+
+// creates and connects all components of the file in circuit, which then owns
+// them, and sets the circuit's seed to the file's
+// circuit is left unchanged if an exception is thrown
+// returns created components, with the same indices as the component records
+std::vector<component::Component *> load(const CircuitFile &circuit_file,
+                                         circuit::Circuit  &circuit,
+                                         unsigned int       n_threads = 0);
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_CIRCUIT_FILE_HPP
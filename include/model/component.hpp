@@ -1,8 +1,11 @@
 #ifndef LOGICSIM_MODEL_COMPONENT_HPP
 #define LOGICSIM_MODEL_COMPONENT_HPP
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <exception>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <string>
@@ -22,23 +25,23 @@ enum State : short
     HiZ  = 2
 };
 
-inline State operator!(const State &x)
+constexpr State operator!(const State &x)
 {
     return static_cast<State>((x != 2) * (1 - x) + (x == 2) * 2);
 }
 
-inline State operator&&(const State &x, const State &y)
+constexpr State operator&&(const State &x, const State &y)
 {
     return static_cast<State>((x == 1) * y + (x == 2) * 2 * (y != 0));
 }
 
-inline State operator||(const State &x, const State &y)
+constexpr State operator||(const State &x, const State &y)
 {
     return static_cast<State>((x == 0) * y + (x == 1) +
                               (x == 2) * (2 - (y == 1)));
 }
 
-inline State operator^(const State &x, const State &y)
+constexpr State operator^(const State &x, const State &y)
 {
     return static_cast<State>((x == 0) * y + (x == 1) * !y + (x == 2) * 2);
 }
@@ -66,9 +69,17 @@ class Component
 
     // returns value for given output, taking delay into account
     State evaluate(unsigned int out = 0);
+    // whether the last tick changed any of the newest evaluations, which only
+    // become outputs after the delay
+    bool changed() const;
+    // whether outputs may change while inputs stay the same (e.g. oscillators)
+    virtual bool autonomous() const;
+    unsigned int delay() const;
 
     virtual void check() const; // checks input components
     virtual void reset();       // resets component state
+    // seeds random evaluations, if any
+    virtual void seed(std::uint64_t seed);
 
     virtual unsigned int n_inputs() const;
     virtual unsigned int n_outputs() const;
@@ -86,14 +97,35 @@ class Component
     virtual void        set_params(const std::string &param_string);
 
   protected:
-    static unsigned int _CURR_ID;
-    unsigned int        _id;
+    // atomic, since components may be created on multiple threads
+    static std::atomic<unsigned int> _CURR_ID;
+    unsigned int                     _id;
 
     size_t                        _history_size;
     unsigned int                  _n_evals;
     std::list<std::vector<State>> _cache_history;
+    bool                          _changed = true;
 
     virtual State _evaluate(unsigned int out = 0) = 0;
+    // stores evaluate(i) as the newest evaluation i, for every i, noting
+    // whether any changed
+    // lets components that evaluate all outputs at once in tick() skip a
+    // virtual _evaluate call per output
+    template <typename F> void _store_evaluations(F evaluate)
+    {
+        // update() reused the oldest evaluations for this tick, so the
+        // previous tick's are next in line, unless there is no delay
+        std::vector<State>       &curr = _cache_history.front();
+        const std::vector<State> &prev = _history_size > 1
+                                           ? *std::next(_cache_history.begin())
+                                           : curr;
+        for (unsigned int i = 0; i < _n_evals; ++i)
+        {
+            State value = evaluate(i);
+            _changed |= value != prev[i];
+            curr[i] = value;
+        }
+    }
 };
 
 // Singleton component object to use for undriven inputs
@@ -168,6 +200,8 @@ class TimeComponent : public Component
     void update() override;
     void reset() override;
 
+    bool autonomous() const override;
+
   protected:
     unsigned long _ticks  = -1;
     bool          _ticked = false;
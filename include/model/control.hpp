@@ -1,8 +1,6 @@
 #ifndef LOGICSIM_MODEL_CONTROL_HPP
 #define LOGICSIM_MODEL_CONTROL_HPP
 
-#include <cmath>
-
 #include "model/component.hpp"
 
 namespace logicsim
@@ -11,44 +9,64 @@ namespace model
 {
 namespace control
 {
+// widest multiplexer and decoder, in select bits
+constexpr unsigned int MAX_SELECT_BITS = 3;
+
+// inputs: enable, 2^BITS data inputs, then BITS select inputs, most
+// significant first
+template <unsigned int BITS>
 class Multiplexer : public component::NInputComponent
 {
+    static_assert(BITS >= 1 && BITS <= MAX_SELECT_BITS,
+                  "Unsupported number of select bits");
+
   public:
-    Multiplexer(unsigned int bits);
+    Multiplexer();
 
     std::string ctype() const override;
 
   protected:
-    unsigned int                _bits;
-    Component                 **_E;
-    unsigned int               *_E_out;
-    std::vector<Component **>   _S;
-    std::vector<unsigned int *> _S_out;
-    std::vector<Component **>   _D;
-    std::vector<unsigned int *> _D_out;
+    static constexpr unsigned int DATA   = 1;
+    static constexpr unsigned int SELECT = DATA + (1u << BITS);
 
     State _evaluate(unsigned int = 0) override;
 };
 
-class Decoder : public component::NInputComponent
+// inputs: BITS address inputs, least significant first, then enable
+template <unsigned int BITS> class Decoder : public component::NInputComponent
 {
+    static_assert(BITS >= 1 && BITS <= MAX_SELECT_BITS,
+                  "Unsupported number of select bits");
+
   public:
-    Decoder(unsigned int bits);
+    Decoder();
+
+    // decodes the address once, before all outputs are evaluated
+    void tick() override;
 
     unsigned int n_outputs() const override;
 
     std::string ctype() const override;
 
   protected:
-    unsigned int                _bits, _outputs;
-    Component                 **_E;
-    unsigned int               *_E_out;
-    std::vector<Component **>   _B;
-    std::vector<unsigned int *> _B_out;
+    static constexpr unsigned int OUTPUTS = 1u << BITS;
+    static constexpr unsigned int ENABLE  = BITS;
+
+    // ONE if the output at _selected is ONE, otherwise the value of every
+    // output (ZERO when disabled, HiZ when an input is HiZ)
+    State        _state    = State::HiZ;
+    unsigned int _selected = 0;
 
     State _evaluate(unsigned int out = 0) override;
 };
 
+extern template class Multiplexer<1>;
+extern template class Multiplexer<2>;
+extern template class Multiplexer<3>;
+
+extern template class Decoder<1>;
+extern template class Decoder<2>;
+extern template class Decoder<3>;
 }
 }
 }
@@ -1,9 +1,12 @@
 #ifndef LOGICSIM_MODEL_INPUTS_HPP
 #define LOGICSIM_MODEL_INPUTS_HPP
 
+#include <cstdint>
 #include <random>
+#include <string>
 
 #include "model/component.hpp"
+#include "model/philox.hpp"
 
 #include "utils.hpp"
 
@@ -108,14 +111,22 @@ class Random : public component::EdgeTriggeredComponent
     unsigned int n_outputs() const override;
 
     std::string ctype() const override;
+    // params: stream, which is picked at random for new components
+    std::string param_string() const override;
+    void        set_params(const std::string &param_string) override;
 
     virtual void tick() override;
     virtual void reset() override;
+    void         seed(std::uint64_t seed) override;
 
   protected:
-    std::random_device                                       _dev;
-    std::mt19937                                             _rng;
-    std::uniform_int_distribution<std::mt19937::result_type> _state_dist;
+    // values drawn on the n-th clock edge since reset are philox(stream, n),
+    // keyed by seed, so runs are reproducible
+    // the stream is saved with the component, so that it stays the same when
+    // other components are added or removed
+    std::uint64_t _seed = 0;
+    std::uint64_t _stream;
+    std::uint64_t _draws = 0;
 
     bool  _evaluated = false;
     State _stored[4] = { State::HiZ, State::HiZ, State::HiZ, State::HiZ };
@@ -1,8 +1,10 @@
 #ifndef LOGICSIM_MODEL_CTYPE_MAP_HPP
 #define LOGICSIM_MODEL_CTYPE_MAP_HPP
 
+#include <array>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -22,11 +24,6 @@ namespace model
     {                                            \
         return new class_t();                    \
     }
-#define DEFINE_FACTORY_FUNCTION_ARG(name, class_t, arg) \
-    inline component::Component *create_##name()        \
-    {                                                   \
-        return new class_t(arg);                        \
-    }
 
 DEFINE_FACTORY_FUNCTION(and, gate::AND)
 DEFINE_FACTORY_FUNCTION(or, gate::OR)
@@ -58,13 +55,13 @@ DEFINE_FACTORY_FUNCTION(output, output::BaseOutput)
 DEFINE_FACTORY_FUNCTION(5in_7segment, output::_5in_7SegmentDisplay)
 DEFINE_FACTORY_FUNCTION(8in_7segment, output::_8in_7SegmentDisplay)
 
-DEFINE_FACTORY_FUNCTION_ARG(mux1, control::Multiplexer, 1)
-DEFINE_FACTORY_FUNCTION_ARG(mux2, control::Multiplexer, 2)
-DEFINE_FACTORY_FUNCTION_ARG(mux3, control::Multiplexer, 3)
+DEFINE_FACTORY_FUNCTION(mux1, control::Multiplexer<1>)
+DEFINE_FACTORY_FUNCTION(mux2, control::Multiplexer<2>)
+DEFINE_FACTORY_FUNCTION(mux3, control::Multiplexer<3>)
 
-DEFINE_FACTORY_FUNCTION_ARG(dec1, control::Decoder, 1)
-DEFINE_FACTORY_FUNCTION_ARG(dec2, control::Decoder, 2)
-DEFINE_FACTORY_FUNCTION_ARG(dec3, control::Decoder, 3)
+DEFINE_FACTORY_FUNCTION(dec1, control::Decoder<1>)
+DEFINE_FACTORY_FUNCTION(dec2, control::Decoder<2>)
+DEFINE_FACTORY_FUNCTION(dec3, control::Decoder<3>)
 
 const std::unordered_map<std::string, std::function<component::Component *()>>
   ctype_map = {
@@ -101,6 +98,85 @@ const std::unordered_map<std::string, std::function<component::Component *()>>
       {        "DEC-2",         &create_dec2 },
       {        "DEC-3",         &create_dec3 }
 };
+
+// Indexed component types, for lookups without string keys (e.g. by parsers)
+constexpr size_t N_CTYPES = 32;
+
+constexpr std::array<std::string_view, N_CTYPES> ctypes = {
+    "AND", "OR", "XOR", "NAND", "NOR", "XNOR", "NOT", "CONNECTOR", "BUFFER",
+    "CONSTANT", "BUTTON", "SWITCH", "OSCILLATOR", "KEYPAD", "RANDOM", "SRLATCH",
+    "JKLATCH", "DLATCH", "TLATCH", "SRFLIPFLOP", "JKFLIPFLOP", "DFLIPFLOP",
+    "TFLIPFLOP", "OUTPUT", "5IN_7SEGMENT", "8IN_7SEGMENT", "MUX-1", "MUX-2",
+    "MUX-3", "DEC-1", "DEC-2", "DEC-3"
+};
+
+constexpr std::array<component::Component *(*)(), N_CTYPES> ctype_factories = {
+    &create_and, &create_or, &create_xor, &create_nand, &create_nor,
+    &create_xnor, &create_not, &create_connector, &create_buffer,
+    &create_constant, &create_button, &create_switch, &create_oscillator,
+    &create_keypad, &create_random, &create_srlatch, &create_jklatch,
+    &create_dlatch, &create_tlatch, &create_srflipflop, &create_jkflipflop,
+    &create_dflipflop, &create_tflipflop, &create_output, &create_5in_7segment,
+    &create_8in_7segment, &create_mux1, &create_mux2, &create_mux3,
+    &create_dec1, &create_dec2, &create_dec3
+};
+
+/* Perfect hash for component types
+ * Mixes the length with the first, second and last characters, which is enough
+ * to tell every type apart; the static_assert below guarantees that no two
+ * types share a slot of ctype_table, so a lookup costs a single string
+ * comparison
+ */
+constexpr size_t CTYPE_TABLE_SIZE = 128;
+
+constexpr size_t ctype_hash(std::string_view ctype)
+{
+    return (ctype.size() + static_cast<unsigned char>(ctype[0]) +
+            22 * static_cast<unsigned char>(ctype[ctype.size() - 1]) +
+            33 * static_cast<unsigned char>(ctype[1])) %
+           CTYPE_TABLE_SIZE;
+}
+
+constexpr std::array<int, CTYPE_TABLE_SIZE> make_ctype_table()
+{
+    std::array<int, CTYPE_TABLE_SIZE> table {};
+    for (auto &slot : table)
+    {
+        slot = -1;
+    }
+    for (size_t i = 0; i < N_CTYPES; ++i)
+    {
+        table[ctype_hash(ctypes[i])] = i;
+    }
+    return table;
+}
+
+constexpr std::array<int, CTYPE_TABLE_SIZE> ctype_table = make_ctype_table();
+
+constexpr bool ctype_hash_is_perfect()
+{
+    for (size_t i = 0; i < N_CTYPES; ++i)
+    {
+        if (ctype_table[ctype_hash(ctypes[i])] != static_cast<int>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(ctype_hash_is_perfect(), "Component type hash has collisions");
+
+// returns index of ctype in ctypes, or -1 if it is not a component type
+constexpr int ctype_index(std::string_view ctype)
+{
+    if (ctype.size() < 2)
+    {
+        return -1;
+    }
+    int idx = ctype_table[ctype_hash(ctype)];
+    return idx >= 0 && ctypes[idx] == ctype ? idx : -1;
+}
 }
 }
 
@@ -0,0 +1,52 @@
+#ifndef LOGICSIM_MODEL_MAPPED_FILE_HPP
+#define LOGICSIM_MODEL_MAPPED_FILE_HPP
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOGICSIM_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+// Read-only contents of a whole file
+// The file is memory-mapped where supported, and read into memory otherwise
+class MappedFile
+{
+  public:
+    // throws std::invalid_argument if the file cannot be opened
+    explicit MappedFile(const std::string &filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char      *data() const;
+    size_t           size() const;
+    std::string_view view() const;
+
+  protected:
+    const char *_data   = nullptr;
+    size_t      _size   = 0;
+    bool        _mapped = false;
+
+    // holds contents when the file is not mapped
+    std::vector<char> _buffer;
+};
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_MAPPED_FILE_HPP
@@ -9,150 +9,71 @@ namespace model
 {
 namespace memory
 {
-class MemoryComponent : virtual public component::NInputComponent
+// how data inputs update the stored state
+enum class MemoryType : unsigned char
 {
-  public:
-    MemoryComponent();
-
-    virtual void tick() override;
-    virtual void reset() override;
-
-    unsigned int n_outputs() const override;
-
-  protected:
-    // Double pointers point to pointers to input components kept by
-    // NInputComponent superclass. Thus, when changing an input component, the
-    // double pointer will automatically point to the new component
-    component::Component **_pre, **_clr;
-    unsigned int          *_pre_out, *_clr_out;
-
-    State _Q         = State::HiZ;
-    bool  _evaluated = false;
-
-    State _evaluate(unsigned int out = 0) override final;
-    // Updates state
-    virtual void _memory_evaluate() = 0;
+    SR,
+    JK,
+    D,
+    T
 };
 
-class SRMemoryComponent : public MemoryComponent
+// when the clock lets data inputs update the stored state
+enum class Trigger : unsigned char
 {
-  public:
-    SRMemoryComponent();
-
-  protected:
-    Component   **_S, **_R;
-    unsigned int *_S_out, *_R_out;
-
-    void _memory_evaluate() override;
+    LEVEL, // while the clock is 1 (latches)
+    EDGE   // when the clock rises (flip-flops)
 };
 
-class JKMemoryComponent : public MemoryComponent
+// Latch or flip-flop, kept as a single record: the type tags, the slots of
+// its inputs and its state
+// Inputs: preset, 1 or 2 data inputs, clock, clear
+// Outputs: Q and Q', both taken from the state computed once per tick
+class MemoryComponent : public component::NInputComponent
 {
   public:
-    JKMemoryComponent();
+    MemoryComponent(MemoryType type, Trigger trigger);
 
-  protected:
-    Component   **_J, **_K;
-    unsigned int *_J_out, *_K_out;
-
-    void _memory_evaluate() override;
-};
+    void tick() override;
+    void reset() override;
 
-class DMemoryComponent : public MemoryComponent
-{
-  public:
-    DMemoryComponent();
+    unsigned int n_outputs() const override;
 
   protected:
-    Component   **_D;
-    unsigned int *_D_out;
+    static constexpr unsigned int PRE = 0;
+    // first data input (S, J, D or T); SR and JK have the second one next
+    static constexpr unsigned int DATA = 1;
 
-    void _memory_evaluate() override;
-};
+    const MemoryType   _type;
+    const Trigger      _trigger;
+    const unsigned int _clk, _clr;
 
-class TMemoryComponent : public MemoryComponent
-{
-  public:
-    TMemoryComponent();
+    State _Q        = State::HiZ;
+    bool  _prev_clk = false;
 
-  protected:
-    Component   **_T;
-    unsigned int *_T_out;
+    // whether the current clock state lets data inputs update the state
+    bool _clk_edge();
 
-    void _memory_evaluate() override;
+    State _evaluate(unsigned int out = 0) override final;
 };
 
-/* Defines a clocked memory component
- * Inputs:
- *  * The class name
- *  * The memory component to inherit from
- *  * The clock type to use
- */
-#define DEFINE_CLOCKED_MEMORY(name, memory_component, clock_type) \
-    class name                                                    \
-      : public memory_component                                   \
-      , public clock_type                                         \
-    {                                                             \
-      public:                                                     \
-        name();                                                   \
-        std::string ctype() const override;                       \
-                                                                  \
-      protected:                                                  \
-        void _memory_evaluate() override;                         \
+// Defines a memory component with a fixed type, trigger and ctype
+#define DEFINE_MEMORY(name)                     \
+    class name : public MemoryComponent         \
+    {                                           \
+      public:                                   \
+        name();                                 \
+        std::string ctype() const override;     \
     };
 
-/* Implements a defined clocked memory component
- * Inputs:
- *  * The class name
- *  * The memory component it inherits from
- *  * The clock type it uses
- *  * The total number of inputs
- *  * The component delay
- *  * The total number of evaluations
- *  * The index of the clock input
- *  * The ctype string
- */
-#define IMPLEMENT_CLOCKED_MEMORY(name,                \
-                                 memory_component,    \
-                                 clock_type,          \
-                                 n,                   \
-                                 delay,               \
-                                 n_evals,             \
-                                 clk_idx,             \
-                                 ctype_str)           \
-    name::name()                                      \
-      : component::NInputComponent(n, delay, n_evals) \
-      , clock_type(clk_idx)                           \
-    {                                                 \
-    }                                                 \
-    std::string name::ctype() const                   \
-    {                                                 \
-        return ctype_str;                             \
-    }                                                 \
-    void name::_memory_evaluate()                     \
-    {                                                 \
-        if (_clk_edge())                              \
-        {                                             \
-            memory_component::_memory_evaluate();     \
-        }                                             \
-    }
-
-DEFINE_CLOCKED_MEMORY(SRLatch, SRMemoryComponent,
-                      component::LevelTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(JKLatch, JKMemoryComponent,
-                      component::LevelTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(DLatch, DMemoryComponent,
-                      component::LevelTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(TLatch, TMemoryComponent,
-                      component::LevelTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(SRFlipFlop, SRMemoryComponent,
-                      component::EdgeTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(JKFlipFlop, JKMemoryComponent,
-                      component::EdgeTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(TFlipFlop, TMemoryComponent,
-                      component::EdgeTriggeredComponent)
-DEFINE_CLOCKED_MEMORY(DFlipFlop, DMemoryComponent,
-                      component::EdgeTriggeredComponent)
+DEFINE_MEMORY(SRLatch)
+DEFINE_MEMORY(JKLatch)
+DEFINE_MEMORY(DLatch)
+DEFINE_MEMORY(TLatch)
+DEFINE_MEMORY(SRFlipFlop)
+DEFINE_MEMORY(JKFlipFlop)
+DEFINE_MEMORY(TFlipFlop)
+DEFINE_MEMORY(DFlipFlop)
 
 }
 }
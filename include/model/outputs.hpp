@@ -1,6 +1,9 @@
 #ifndef LOGICSIM_MODEL_OUTPUTS_HPP
 #define LOGICSIM_MODEL_OUTPUTS_HPP
 
+#include <array>
+#include <cstdint>
+
 #include "model/component.hpp"
 
 namespace logicsim
@@ -28,19 +31,92 @@ class BaseOutput : public Output
     State _evaluate(unsigned int = 0) override;
 };
 
+// evaluation out of a 5 input 7 segment display, for inputs x
+// evaluation 0 is the dot (input 4), evaluations 1 to 7 are the segments
+constexpr State _5in_7segment_evaluate(const State (&x)[5], unsigned int out)
+{
+    switch (out)
+    {
+    case 1:
+        return !((x[0] && x[1] && x[2]) || (x[0] && x[1] && !x[2] && !x[3]) ||
+                 (!x[0] && !x[1] && x[2] && !x[3]));
+    case 2:
+        return !((x[1] && x[2] && x[3]) || (!x[0] && x[1] && !x[2] && !x[3]) ||
+                 (!x[0] && !x[1] && !x[2] && x[3]) ||
+                 (x[0] && !x[1] && x[2] && !x[3]));
+    case 3:
+        return !((!x[0] && x[3]) || (!x[0] && x[1] && !x[2] && !x[3]) ||
+                 (x[0] && !x[1] && !x[2] && x[3]));
+    case 4:
+        return !((!x[0] && !x[1] && !x[2]) || (!x[0] && x[1] && x[2] && x[3]) ||
+                 (x[0] && x[1] && !x[2] && !x[3]));
+    case 5:
+        return !((!x[0] && !x[1] && x[2]) || (!x[0] && x[2] && x[3]) ||
+                 (!x[0] && !x[1] && !x[2] && x[3]) ||
+                 (x[0] && x[1] && !x[2] && x[3]));
+    case 6:
+        return !((!x[0] && !x[1] && !x[2] && x[3]) ||
+                 (!x[0] && x[1] && !x[2] && !x[3]) ||
+                 (x[0] && x[1] && !x[2] && x[3]) ||
+                 (x[0] && !x[1] && x[2] && x[3]));
+    case 7:
+        return !((x[1] && x[2] && !x[3]) || (x[0] && x[1] && x[2]) ||
+                 (x[0] && x[2] && x[3]) || (x[0] && x[1] && !x[3]) ||
+                 (!x[0] && x[1] && !x[2] && x[3]));
+    case 0:
+    default:
+        return x[4];
+    }
+}
+
+// bit of input in the packed value shown by a 5 input 7 segment display: the
+// nibble of inputs 0 to 3, most significant first, then the dot
+constexpr unsigned int _5in_7segment_bit(unsigned int input)
+{
+    return input < 4 ? 3 - input : 4;
+}
+
+// all 8 evaluations of a 5 input 7 segment display, for every combination of
+// inputs, indexed by the packed value of the inputs at ONE plus the packed
+// value of the inputs at HiZ shifted by 5
+// evaluation i takes bits 2i and 2i + 1 of each entry
+constexpr std::array<std::uint16_t, 1024> make_5in_7segment_table()
+{
+    std::array<std::uint16_t, 1024> table {};
+    for (unsigned int idx = 0; idx < table.size(); ++idx)
+    {
+        State x[5] = {};
+        for (unsigned int i = 0; i < 5; ++i)
+        {
+            unsigned int bit = _5in_7segment_bit(i);
+            x[i]             = (idx >> (bit + 5)) & 1
+                                 ? State::HiZ
+                                 : static_cast<State>((idx >> bit) & 1);
+        }
+        for (unsigned int out = 0; out < 8; ++out)
+        {
+            table[idx] |= _5in_7segment_evaluate(x, out) << (2 * out);
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::uint16_t, 1024> _5in_7segment_table =
+  make_5in_7segment_table();
+
 class _5in_7SegmentDisplay : public Output
 {
   public:
     _5in_7SegmentDisplay();
 
+    // looks up all evaluations once, before they are stored
     void tick() override;
 
     std::string ctype() const override;
 
   protected:
-    State _input_cache[5];
-    bool  _ticked = false;
-    State _evaluate(unsigned int out = 0) override;
+    std::uint16_t _evals = 0;
+    State         _evaluate(unsigned int out = 0) override;
 };
 
 class _8in_7SegmentDisplay : public Output
@@ -48,13 +124,13 @@ class _8in_7SegmentDisplay : public Output
   public:
     _8in_7SegmentDisplay();
 
+    // reads all inputs once, before they are stored
     void tick() override;
 
     std::string ctype() const override;
 
   protected:
     State _input_cache[8];
-    bool  _ticked = false;
     State _evaluate(unsigned int out = 0) override;
 };
 }
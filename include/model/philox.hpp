@@ -0,0 +1,59 @@
+#ifndef LOGICSIM_MODEL_PHILOX_HPP
+#define LOGICSIM_MODEL_PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace logicsim
+{
+namespace model
+{
+namespace random
+{
+/* Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3")
+ * Maps a counter and a key to 128 random bits, without any state, so any
+ * value of a sequence can be drawn directly, by any thread
+ */
+typedef std::array<std::uint32_t, 4> PhiloxCounter;
+typedef std::array<std::uint32_t, 2> PhiloxKey;
+
+constexpr std::uint32_t PHILOX_M0     = 0xD2511F53;
+constexpr std::uint32_t PHILOX_M1     = 0xCD9E8D57;
+constexpr std::uint32_t PHILOX_W0     = 0x9E3779B9;
+constexpr std::uint32_t PHILOX_W1     = 0xBB67AE85;
+constexpr unsigned int  PHILOX_ROUNDS = 10;
+
+inline PhiloxCounter philox(PhiloxCounter counter, PhiloxKey key)
+{
+    for (unsigned int i = 0; i < PHILOX_ROUNDS; ++i)
+    {
+        std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * counter[0];
+        std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * counter[2];
+        counter = { static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<std::uint32_t>(p0) };
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+
+    return counter;
+}
+
+// counter and key made of two 64-bit values each
+inline PhiloxCounter philox(std::uint64_t c0, std::uint64_t c1,
+                            std::uint64_t k)
+{
+    return philox({ static_cast<std::uint32_t>(c0),
+                    static_cast<std::uint32_t>(c0 >> 32),
+                    static_cast<std::uint32_t>(c1),
+                    static_cast<std::uint32_t>(c1 >> 32) },
+                  { static_cast<std::uint32_t>(k),
+                    static_cast<std::uint32_t>(k >> 32) });
+}
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_PHILOX_HPP
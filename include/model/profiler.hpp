@@ -0,0 +1,90 @@
+#ifndef LOGICSIM_MODEL_PROFILER_HPP
+#define LOGICSIM_MODEL_PROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "model/mapped_data.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace profile
+{
+/* Histogram of latencies (in nanoseconds), with buckets of logarithmically
+ * increasing width, as in HdrHistogram
+ * Values below 2^SUB_BUCKET_BITS have their own bucket; every power of two
+ * above that is split into 2^(SUB_BUCKET_BITS - 1) buckets, so recorded
+ * values are kept with a relative error below 2^-(SUB_BUCKET_BITS - 1)
+ * Any 64-bit value can be recorded, in constant time and memory
+ */
+class LatencyHistogram
+{
+  public:
+    static const unsigned int SUB_BUCKET_BITS = 6;
+
+    LatencyHistogram();
+
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t count() const;
+    std::uint64_t min() const;
+    std::uint64_t max() const;
+    double        mean() const;
+    // highest value equivalent to the value below which percentile (0-100)
+    // of recorded values fall
+    std::uint64_t value_at_percentile(double percentile) const;
+
+  protected:
+    static const unsigned int SUB_BUCKETS      = 1 << SUB_BUCKET_BITS;
+    static const unsigned int HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static const unsigned int N_BUCKETS =
+      SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+    std::vector<std::uint64_t> _buckets;
+    std::uint64_t              _count = 0;
+    std::uint64_t              _min   = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t              _max   = 0;
+    double                     _sum   = 0;
+
+    static unsigned int  _bucket_index(std::uint64_t value);
+    // highest value recorded in bucket
+    static std::uint64_t _bucket_max(unsigned int index);
+};
+
+// counters for all components of a type
+struct CtypeCounters
+{
+    // number of evaluations (component ticks)
+    std::uint64_t evaluations = 0;
+    // time spent on ticks and updates of components
+    std::uint64_t nanoseconds = 0;
+};
+
+// index of counters for components of types missing from model::ctypes
+constexpr size_t OTHER_CTYPE = N_CTYPES;
+
+struct Profile
+{
+    std::uint64_t                             ticks = 0;
+    std::array<CtypeCounters, N_CTYPES + 1>   ctypes;
+    LatencyHistogram                          tick_latency;
+
+    void reset();
+
+    void        write_json(std::ostream &stream) const;
+    std::string json() const;
+};
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_PROFILER_HPP
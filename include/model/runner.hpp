@@ -0,0 +1,331 @@
+#ifndef LOGICSIM_MODEL_RUNNER_HPP
+#define LOGICSIM_MODEL_RUNNER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "model/circuit.hpp"
+#include "model/component.hpp"
+#include "model/inputs.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace sim
+{
+// Values of all component evaluations after some tick
+struct Snapshot
+{
+    std::uint64_t      tick = 0;
+    // ticks per second achieved recently, or 0 while paused or idle
+    double             rate = 0;
+    // whether the circuit settled while running, so that ticks are no longer
+    // performed until an input event arrives
+    bool               idle = false;
+    // evaluations of each component, starting from its slot
+    std::vector<State> values;
+    // number of times watchpoints paused the simulation so far, and handles of
+    // the watchpoints which fired the last time they did
+    unsigned int              n_triggers = 0;
+    std::vector<unsigned int> triggered;
+
+    State value(size_t slot, unsigned int out = 0) const
+    {
+        return values[slot + out];
+    }
+};
+
+// What the runner publishes: a snapshot without its values, and the values of
+// the components which may have changed since the last snapshot the owner read
+struct SnapshotUpdate
+{
+    std::uint64_t             tick = 0;
+    double                    rate = 0;
+    bool                      idle = false;
+    unsigned int              n_triggers = 0;
+    std::vector<unsigned int> triggered;
+    // indices of components (in Circuit::components() order), and all of
+    // their evaluations, in the same order
+    std::vector<size_t> components;
+    std::vector<State>  values;
+};
+
+// Interaction with an input component
+struct InputEvent
+{
+    enum Action
+    {
+        PRESS,   // BUTTON
+        RELEASE, // BUTTON
+        SET,     // SWITCH, CONSTANT: value is the new value
+        KEY      // KEYPAD: value is the key
+    };
+
+    component::Component *component;
+    Action                action;
+    unsigned int          value;
+    // event takes effect once this many ticks have been simulated, or as soon
+    // as possible if more have already been
+    std::uint64_t tick;
+};
+
+// Lock-free queue, for a single producer and a single consumer thread
+template <typename T> class SpscQueue
+{
+  public:
+    // capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity) : _head(0), _tail(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        _items.resize(size);
+        _mask = size - 1;
+    }
+
+    // producer only; returns false if the queue is full
+    bool push(const T &item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _items.size())
+        {
+            return false;
+        }
+        _items[tail & _mask] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; returns false if the queue is empty
+    bool pop(T &item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = _items[head & _mask];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) ==
+               _tail.load(std::memory_order_acquire);
+    }
+
+  protected:
+    std::vector<T>      _items;
+    size_t              _mask;
+    std::atomic<size_t> _head, _tail;
+};
+
+/* Lock-free buffer for passing values from a writer to a reader thread
+ * The writer fills the back buffer and publishes it, swapping it with the
+ * middle one; the reader swaps the middle buffer with the front one when a new
+ * one has been published, and reads the front one
+ * Neither side ever waits for the other, and the reader always gets the latest
+ * published value
+ */
+template <typename T> class TripleBuffer
+{
+  public:
+    TripleBuffer() : _middle(2) {}
+
+    // writer only
+    T &back()
+    {
+        return _buffers[_back];
+    }
+
+    // returns whether the reader took the previously published value
+    bool publish()
+    {
+        unsigned int middle =
+          _middle.exchange(_back | FRESH, std::memory_order_acq_rel);
+        _back = middle & INDEX;
+        return !(middle & FRESH);
+    }
+
+    // reader only
+    // returns true if a new value was published since last called
+    bool update()
+    {
+        if (!(_middle.load(std::memory_order_relaxed) & FRESH))
+        {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T &front() const
+    {
+        return _buffers[_front];
+    }
+
+  protected:
+    static const unsigned int INDEX = 3;
+    static const unsigned int FRESH = 4;
+
+    T                         _buffers[3];
+    unsigned int              _back  = 0;
+    unsigned int              _front = 1;
+    std::atomic<unsigned int> _middle;
+};
+
+/* Runs a circuit on a worker thread
+ * The circuit is ticked at the set frequency while running; its state is
+ * published as snapshots, which the owner reads at its own rate, and input
+ * interactions are posted to the worker through a queue, so neither side waits
+ * for the other
+ * Only the evaluations of components which changed are published, and applied
+ * to the owner's snapshot
+ * Once the circuit has settled, the worker sleeps until woken up (e.g. by an
+ * input event), then counts the ticks which would have been performed
+ * meanwhile (none at MAX_SPEED)
+ * While the runner exists, the circuit must only be accessed through
+ * exclusive(); the runner is created paused
+ * All methods are meant to be called from a single (owner) thread
+ */
+class Runner
+{
+  public:
+    // frequency to run as fast as possible
+    static const unsigned int MAX_SPEED = 0;
+
+    explicit Runner(circuit::Circuit &circuit, unsigned int frequency);
+    ~Runner();
+
+    // offset of the component's evaluations in snapshot values
+    size_t slot(const component::Component &component) const;
+
+    void         set_frequency(unsigned int frequency);
+    unsigned int frequency() const;
+
+    void pause();
+    void resume();
+    bool paused() const;
+    // performs ticks more ticks while paused, in the background
+    // pause() cancels those not yet performed
+    void          step(std::uint64_t ticks);
+    // ticks requested by step() which are not yet performed
+    std::uint64_t steps() const;
+
+    void post(const InputEvent &event);
+
+    // calls func with the circuit while the worker waits, then publishes a
+    // snapshot
+    void exclusive(const std::function<void(circuit::Circuit &)> &func);
+    void reset();
+
+    // switches to the latest published snapshot
+    // returns true if one was published since last called
+    bool            update_snapshot();
+    const Snapshot &snapshot() const;
+    // indices of components (in Circuit::components() order) with evaluations
+    // that changed on the last switch to a new snapshot
+    const std::vector<size_t> &changed() const;
+
+  protected:
+    typedef std::chrono::steady_clock clock;
+
+    // snapshots are not published more often than this while running
+    static constexpr std::chrono::milliseconds PUBLISH_INTERVAL { 8 };
+    // achieved rate is measured over this interval
+    static constexpr std::chrono::milliseconds RATE_INTERVAL { 500 };
+    static const size_t                        EVENT_QUEUE_SIZE  = 1024;
+    static const std::uint64_t                 CHECK_EVALUATIONS = 4096;
+    static const std::uint64_t                 NS_PER_SECOND = 1000000000;
+
+    circuit::Circuit                                       &_circuit;
+    std::unordered_map<const component::Component *, size_t> _slots;
+    // slot of each component, followed by the total number of values
+    std::vector<size_t> _offsets;
+
+    // snapshot as of the last switch (owner only)
+    Snapshot            _shown;
+    std::vector<size_t> _changed;
+
+    TripleBuffer<SnapshotUpdate> _updates;
+    unsigned int                 _n_triggers = 0;
+    std::vector<unsigned int>    _triggered;
+
+    // Changes which the owner may not have read yet (circuit mutex held)
+    struct Unread
+    {
+        bool          listed = false;
+        // tick at which the last change of newest evaluations reaches the
+        // outputs, and number of the first update published since then, or 0
+        std::uint64_t output_tick  = 0;
+        std::uint64_t published_in = 0;
+    };
+    // components listed as unread, which each update carries
+    std::vector<size_t> _unread;
+    std::vector<Unread> _unread_state;
+    std::uint64_t       _n_updates = 0;
+    // latest update which the owner is known to have taken
+    std::uint64_t       _read_update = 0;
+
+    double            _rate = 0;
+    clock::time_point _rate_time;
+    std::uint64_t     _rate_tick = 0;
+
+    SpscQueue<InputEvent> _events;
+    // events waiting for their tick (worker only)
+    std::deque<InputEvent> _pending;
+
+    // held by the worker while ticking, and by exclusive()
+    std::mutex        _circuit_mutex;
+    std::atomic<bool> _exclusive_waiting;
+
+    std::mutex              _wake_mutex;
+    std::condition_variable _wake;
+
+    std::atomic<bool>          _stop;
+    std::atomic<bool>          _paused;
+    std::atomic<unsigned int>  _frequency;
+    std::atomic<std::uint64_t> _steps;
+
+    // set by the worker when the circuit settles while running
+    // the rest is only accessed with the circuit mutex held
+    std::atomic<bool> _idle;
+    clock::time_point _idle_since;
+    unsigned int      _idle_frequency = 0;
+
+    std::thread _thread;
+
+    void _notify();
+    void _run();
+    // applies events due by the current tick
+    void _apply_events();
+    // lists components whose newest evaluations changed on the last tick, or
+    // all components if all is set
+    void _collect_changes(bool all = false);
+    // fills the back update with the unread changes, and publishes it
+    void _publish();
+    // counts the ticks which passed while idle, and stops being idle
+    // circuit mutex must be held
+    void _wake_up();
+    // ticks due in elapsed time at frequency
+    static std::uint64_t _due_ticks(clock::duration elapsed,
+                                    unsigned int    frequency);
+};
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_RUNNER_HPP
@@ -0,0 +1,68 @@
+#ifndef LOGICSIM_MODEL_WATCHPOINT_HPP
+#define LOGICSIM_MODEL_WATCHPOINT_HPP
+
+#include <stdexcept>
+#include <vector>
+
+#include "model/component.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace watch
+{
+enum WatchType
+{
+    RISING_EDGE,
+    FALLING_EDGE,
+    ANY_EDGE,
+    LEVEL,
+    PATTERN,
+    HIGH_IMPEDANCE
+};
+
+// single evaluation of a component (output index, or evaluation index for
+// outputs such as LEDs)
+struct Probe
+{
+    component::Component *component;
+    unsigned int          out;
+};
+
+// Condition on component outputs, checked by the circuit after every tick
+// RISING_EDGE, FALLING_EDGE, ANY_EDGE: fire on a ZERO/ONE transition of the
+// single probe
+// LEVEL: fires when the single probe takes values[0]
+// PATTERN: fires when every probe takes its respective value in values
+// HIGH_IMPEDANCE: fires when the single probe becomes HiZ
+// Level conditions (LEVEL, PATTERN, HIGH_IMPEDANCE) fire when they become true,
+// and also on the first tick after being added or reset if already true
+struct Watchpoint
+{
+    WatchType          type;
+    std::vector<Probe> probes;
+    std::vector<State> values;
+
+    // whether the condition holds for a probe going from prev to curr
+    // applies to single probe conditions
+    bool fires(State prev, State curr) const;
+    // whether all probes currently match values
+    // applies to PATTERN
+    bool matches() const;
+};
+
+Watchpoint rising_edge(component::Component &component, unsigned int out = 0);
+Watchpoint falling_edge(component::Component &component, unsigned int out = 0);
+Watchpoint any_edge(component::Component &component, unsigned int out = 0);
+Watchpoint level(component::Component &component, unsigned int out,
+                 State value);
+Watchpoint pattern(const std::vector<Probe> &probes,
+                   const std::vector<State> &values);
+Watchpoint high_impedance(component::Component &component,
+                          unsigned int          out = 0);
+}
+}
+}
+
+#endif // LOGICSIM_MODEL_WATCHPOINT_HPP
@@ -0,0 +1,126 @@
+#ifndef LOGICSIM_TOOLS_GENERATORS_HPP
+#define LOGICSIM_TOOLS_GENERATORS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace logicsim
+{
+namespace tools
+{
+/* Synthetic circuit generators
+ * Generators add circuits of a given size to a CircuitBuilder, which writes
+ * them as circuit files (.lsc)
+ * Circuit inputs are driven by oscillators of different periods, so that
+ * generated circuits keep changing when simulated
+ */
+
+// output of a component in a generated circuit
+struct Pin
+{
+    unsigned int id;
+    unsigned int out;
+};
+
+// undriven input
+constexpr Pin NULL_PIN = { std::numeric_limits<unsigned int>::max(), 0 };
+
+class CircuitBuilder
+{
+  public:
+    // seed: simulation seed written to the file, used by Random components
+    explicit CircuitBuilder(unsigned int  frequency = 1000,
+                            std::uint64_t seed      = 0);
+
+    // adds a component at grid cell (col, row), relative to the origin
+    // returns its id
+    unsigned int add(const std::string &ctype, int col, int row,
+                     const std::vector<Pin> &inputs = {},
+                     const std::string      &params = "");
+    // connects input of an added component, for inputs driven by components
+    // added after it
+    void connect(unsigned int id, unsigned int input, Pin pin);
+
+    // moves the origin to grid cell (col, row)
+    void set_origin(int col, int row);
+    // number of columns and rows used since the origin was last set
+    int width() const;
+    int height() const;
+
+    size_t size() const;
+
+    void        write(std::ostream &stream) const;
+    std::string str() const;
+
+    // distance between grid cells, in native coordinates
+    static const int CELL_SIZE = 100;
+
+  protected:
+    struct Entry
+    {
+        std::string      ctype;
+        std::string      params;
+        int              x, y;
+        std::vector<Pin> inputs;
+    };
+
+    unsigned int       _frequency;
+    std::uint64_t      _seed;
+    std::vector<Entry> _entries;
+    int                _origin_col = 0, _origin_row = 0;
+    int                _width = 0, _height = 0;
+};
+
+// oscillator with the given number of ticks per half period
+Pin clock(CircuitBuilder &builder, int col, int row, unsigned int half_period);
+// oscillator for the i-th input of a circuit, so that inputs change at
+// different rates
+Pin source(CircuitBuilder &builder, int col, int row, unsigned int i);
+
+// n-bit ripple-carry adder of full adders made of XOR, AND and OR gates
+void ripple_carry_adder(CircuitBuilder &builder, unsigned int bits);
+// n-bit asynchronous counter of TFlipFlops, each clocked by the previous
+// one's Q', as in saves/counter.lsc
+// flip-flops are cleared by a pulse when the simulation starts
+void counter(CircuitBuilder &builder, unsigned int bits);
+// random directed acyclic graph of gates, each driven by gates or sources
+// close before it; the same seed always produces the same circuit
+void random_dag(CircuitBuilder &builder, unsigned int gates, unsigned int seed);
+// chain of CONNECTORs, evaluated with no delay
+void connector_chain(CircuitBuilder &builder, unsigned int length);
+// tree of MUX-3 with 8^levels data inputs
+void mux_tree(CircuitBuilder &builder, unsigned int levels);
+// tree of DEC-3 with 8^levels outputs, each level enabling the next
+void decoder_tree(CircuitBuilder &builder, unsigned int levels);
+// n-bit by n-bit array multiplier, adding AND partial products by rows of
+// ripple-carry adders
+void array_multiplier(CircuitBuilder &builder, unsigned int bits);
+// n-bit Fibonacci linear feedback shift register of DFlipFlops, with XOR
+// feedback from taps giving a maximal length sequence for up to 32 bits
+// the register is seeded by a pulse when the simulation starts
+void lfsr(CircuitBuilder &builder, unsigned int bits);
+// register file of 2^address_bits registers of width bits, made of
+// DFlipFlops, written through a decoder and read through multiplexers
+// address_bits must be between 1 and 3
+void register_file(CircuitBuilder &builder, unsigned int address_bits,
+                   unsigned int width);
+
+// lays out count instances added by generate on a grid, starting from cell
+// (0, 0), in about as many rows as columns
+// instances are assumed to have the same size as the first one
+void tile(CircuitBuilder &builder, unsigned int count,
+          const std::function<void(CircuitBuilder &)> &generate);
+}
+}
+
+#endif // LOGICSIM_TOOLS_GENERATORS_HPP
@@ -1,8 +1,13 @@
 #ifndef LOGICSIM_UTILS_HPP
 #define LOGICSIM_UTILS_HPP
 
+#include <algorithm>
 #include <cmath>
+#include <exception>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace logicsim
@@ -27,9 +32,40 @@ class StringSplitter
     bool        _done = false;
 };
 
+// same as StringSplitter, but returns views into str, which must outlive the
+// splitter
+class StringViewSplitter
+{
+  public:
+    StringViewSplitter();
+    StringViewSplitter(std::string_view str, char delimiter);
+
+    bool             has_next() const;
+    std::string_view next();
+
+    void reset(std::string_view str, char delimiter);
+
+  protected:
+    std::string_view _str;
+    char             _delimiter;
+    size_t           _pos  = 0;
+    bool             _done = false;
+};
+
 size_t get_int_from_bools(std::vector<bool> bools);
 
-bool is_positive_int(std::string str);
+bool is_positive_int(std::string_view str);
+
+// number of threads to use for n_threads requested (0: one per hardware
+// thread)
+unsigned int thread_count(unsigned int n_threads = 0);
+
+// splits [0, n) into up to n_threads contiguous ranges, and calls
+// func(begin, end) for each range on its own thread
+// if any call throws, the exception of the first range (by position) that
+// threw is rethrown, once all calls have finished
+void parallel_for(size_t n, unsigned int n_threads,
+                  const std::function<void(size_t, size_t)> &func);
 }
 }
 
@@ -0,0 +1,40 @@
+# Model sources, shared by the GUI and all command-line targets
+INCLUDEPATH += $$PWD/include/
+# large circuit files are loaded, and circuits simulated, on multiple threads
+CONFIG += thread
+# uncomment to compile out profiling (Circuit::set_profiling)
+# DEFINES += LOGICSIM_NO_PROFILING
+
+SOURCES += \
+    $$PWD/src/model/binary_file.cpp \
+    $$PWD/src/model/circuit.cpp \
+    $$PWD/src/model/circuit_file.cpp \
+    $$PWD/src/model/component.cpp \
+    $$PWD/src/model/gates.cpp \
+    $$PWD/src/model/inputs.cpp \
+    $$PWD/src/model/mapped_file.cpp \
+    $$PWD/src/model/memory.cpp \
+    $$PWD/src/model/outputs.cpp \
+    $$PWD/src/model/profiler.cpp \
+    $$PWD/src/model/runner.cpp \
+    $$PWD/src/model/control.cpp \
+    $$PWD/src/model/watchpoint.cpp \
+    $$PWD/src/utils.cpp
+
+HEADERS += \
+    $$PWD/include/model/binary_file.hpp \
+    $$PWD/include/model/circuit.hpp \
+    $$PWD/include/model/circuit_file.hpp \
+    $$PWD/include/model/component.hpp \
+    $$PWD/include/model/gates.hpp \
+    $$PWD/include/model/inputs.hpp \
+    $$PWD/include/model/mapped_data.hpp \
+    $$PWD/include/model/mapped_file.hpp \
+    $$PWD/include/model/memory.hpp \
+    $$PWD/include/model/outputs.hpp \
+    $$PWD/include/model/philox.hpp \
+    $$PWD/include/model/profiler.hpp \
+    $$PWD/include/model/runner.hpp \
+    $$PWD/include/model/control.hpp \
+    $$PWD/include/model/watchpoint.hpp \
+    $$PWD/include/utils.hpp
@@ -17,6 +17,12 @@ void Clipboard::copy(std::vector<ComponentLabel *> components)
         _component_reprs[i].comp_type = components[i]->comp_type();
         _component_reprs[i].res_idx   = components[i]->resourceIdx();
         _component_reprs[i].params    = components[i]->params();
+        // pasted random inputs draw their own values, instead of the copied
+        // ones, so they keep the stream they are created with
+        if (_component_reprs[i].comp_type == RANDOM)
+        {
+            _component_reprs[i].params.clear();
+        }
         _component_reprs[i].x         = components[i]->x();
         _component_reprs[i].y         = components[i]->y();
 
@@ -61,7 +67,7 @@ void Clipboard::paste()
     {
         components[i] = new ComponentLabel(_component_reprs[i].comp_type,
                                            _component_reprs[i].res_idx,
-                                           _design_area->getScale(),
+                                           _design_area->_view,
                                            _design_area->_undo_stack,
                                            _design_area);
         components[i]->setParams(_component_reprs[i].params);
@@ -83,7 +89,7 @@ void Clipboard::paste()
         {
             if (_component_reprs[i].inputs[j].first != nullptr)
             {
-                Wire *wire = new Wire(_design_area->getScale(), _design_area);
+                Wire *wire = new Wire(_design_area->_view, _design_area);
                 wire->setComponent1(components[i], true, j);
                 wire->setComponent2(
                   component_map[_component_reprs[i].inputs[j].first],
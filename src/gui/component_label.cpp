@@ -6,30 +6,15 @@ namespace logicsim
 namespace gui
 {
 ComponentLabel::ComponentLabel(COMPONENT comp_type, int resource_idx,
-                               double scale, QUndoStack *stack, QWidget *parent)
-  : QLabel { parent }
-  , _comp_type(comp_type)
-  , _undo_stack(stack)
-  , _scale(scale)
+                               const QTransform &view, QUndoStack *stack,
+                               QWidget *parent)
+  : ComponentLabel(comp_type,
+                   resource_idx,
+                   model::ctype_map.at(comp_type_to_ctype.at(comp_type))(),
+                   view,
+                   stack,
+                   parent)
 {
-    _input_wires =
-      std::vector<Wire *>(resources::comp_io_rel_pos.at(comp_type).first.size(),
-                          nullptr);
-    _output_wires = std::vector<std::vector<Wire *>>(
-      resources::comp_io_rel_pos.at(comp_type).second.size(),
-      std::vector<Wire *>());
-
-    setResourceByIdx(resource_idx);
-
-    _border = new QLabel(this);
-    _border->setPixmap(resources::getBorder(width(), height()));
-    _border->resize(width(), height());
-    _border->setAttribute(Qt::WA_TransparentForMouseEvents);
-    _border->move(0, 0);
-    _border->hide();
-
-    _component_model = model::ctype_map.at(comp_type_to_ctype.at(comp_type))();
-
     switch (comp_type)
     {
     case CONSTANT:
@@ -42,6 +27,26 @@ ComponentLabel::ComponentLabel(COMPONENT comp_type, int resource_idx,
     }
 }
 
+ComponentLabel::ComponentLabel(COMPONENT comp_type, int resource_idx,
+                               model::component::Component *component_model,
+                               const QTransform &view, QUndoStack *stack,
+                               QWidget *parent)
+  : QObject { parent }
+  , _comp_type(comp_type)
+  , _design_area(parent)
+  , _view(&view)
+  , _component_model(component_model)
+  , _undo_stack(stack)
+{
+    _input_wires =
+      std::vector<Wire *>(resources::comp_io_rel_pos.at(comp_type).first.size(),
+                          nullptr);
+    _output_nets =
+      std::vector<Net>(resources::comp_io_rel_pos.at(comp_type).second.size());
+
+    setResourceByIdx(resource_idx);
+}
+
 ComponentLabel::~ComponentLabel()
 {
     for (const auto &wire : _input_wires)
@@ -53,17 +58,15 @@ ComponentLabel::~ComponentLabel()
         }
     }
 
-    for (const auto &output : _output_wires)
+    for (const auto &net : _output_nets)
     {
-        for (const auto &wire : output)
+        for (const auto &wire : net.wires)
         {
             wire->removeFromOppositeComponent(this);
             delete wire;
         }
     }
 
-    delete _border;
-
     delete _component_model;
 }
 
@@ -78,16 +81,16 @@ void ComponentLabel::removeFromCircuit()
         }
     }
 
-    for (const auto &output : _output_wires)
+    for (const auto &net : _output_nets)
     {
-        for (const auto &wire : output)
+        for (const auto &wire : net.wires)
         {
             wire->removeFromOppositeComponent(this);
             wire->hide();
         }
     }
 
-    _border->hide();
+    hideBorder();
 }
 
 void ComponentLabel::bringBackToCircuit()
@@ -101,9 +104,9 @@ void ComponentLabel::bringBackToCircuit()
         }
     }
 
-    for (const auto &output : _output_wires)
+    for (const auto &net : _output_nets)
     {
-        for (const auto &wire : output)
+        for (const auto &wire : net.wires)
         {
             if (wire != nullptr)
             {
@@ -125,23 +128,132 @@ model::component::Component *ComponentLabel::component_model() const
     return _component_model;
 }
 
+int ComponentLabel::x() const
+{
+    return _geometry.x();
+}
+
+int ComponentLabel::y() const
+{
+    return _geometry.y();
+}
+
+int ComponentLabel::width() const
+{
+    return _geometry.width();
+}
+
+int ComponentLabel::height() const
+{
+    return _geometry.height();
+}
+
+QPoint ComponentLabel::pos() const
+{
+    return _geometry.topLeft();
+}
+
+const QRect &ComponentLabel::geometry() const
+{
+    return _geometry;
+}
+
+QRect ComponentLabel::viewGeometry() const
+{
+    // sized like the scaled images
+    double scale = _view->m11();
+    return QRect(_view->map(_geometry.topLeft()),
+                 QSize(static_cast<int>(scale * _geometry.width()),
+                       static_cast<int>(scale * _geometry.height())));
+}
+
+unsigned long ComponentLabel::stackingOrder() const
+{
+    return _stacking_order;
+}
+
+void ComponentLabel::setStackingOrder(unsigned long order)
+{
+    _stacking_order = order;
+}
+
+void ComponentLabel::show()
+{
+    _hidden = false;
+    _update();
+}
+
+void ComponentLabel::hide()
+{
+    _update();
+    _hidden = true;
+}
+
+bool ComponentLabel::isHidden() const
+{
+    return _hidden;
+}
+
+void ComponentLabel::paint(QPainter &painter) const
+{
+    QRect view_geometry = viewGeometry();
+    painter.drawPixmap(
+      view_geometry.topLeft(),
+      resources::getComponentResource(_comp_type, _resource_idx, _view->m11()));
+    if (_border_visible)
+    {
+        painter.setPen(Qt::black);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(view_geometry.adjusted(0, 0, -1, -1));
+    }
+}
+
+void ComponentLabel::paintLowDetail(QPainter &painter) const
+{
+    QRect view_geometry = viewGeometry();
+    painter.fillRect(view_geometry,
+                     _state == model::State::ZERO
+                       ? resources::getLineColor()
+                       : resources::getWireColor(_state));
+    if (_border_visible)
+    {
+        painter.setPen(Qt::black);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(view_geometry.adjusted(0, 0, -1, -1));
+    }
+}
+
+void ComponentLabel::_update() const
+{
+    if (!_hidden)
+    {
+        _design_area->update(viewGeometry());
+    }
+}
+
 void ComponentLabel::showBorder()
 {
-    _border->show();
+    _border_visible = true;
+    _update();
 }
 
 void ComponentLabel::hideBorder()
 {
-    _border->hide();
+    _border_visible = false;
+    _update();
 }
 
 void ComponentLabel::setResourceByIdx(int idx)
 {
+    // geometry is empty until the first resource is set
+    if (idx == _resource_idx && !_geometry.isEmpty())
+    {
+        return;
+    }
     _resource_idx = idx;
-    QPixmap res =
-      resources::getComponentResource(_comp_type, _resource_idx, _scale);
-    setPixmap(res);
-    resize(res.width(), res.height());
+    _update();
+    _geometry.setSize(resources::getComponentSize(_comp_type, _resource_idx));
+    _update();
 }
 
 int ComponentLabel::resourceIdx() const
@@ -154,21 +266,13 @@ QString ComponentLabel::params() const
     return QString::fromStdString(_component_model->param_string());
 }
 
-QPoint ComponentLabel::getNativeCoordinates(double inverse_scale_factor,
-                                            double inverse_translation_x,
-                                            double inverse_translation_y)
-{
-    return QPoint(inverse_scale_factor * x() + inverse_translation_x,
-                  inverse_scale_factor * y() + inverse_translation_y);
-}
-
 const std::vector<Wire *> ComponentLabel::inputWires() const
 {
     return _input_wires;
 }
-const std::vector<std::vector<Wire *>> ComponentLabel::outputWires() const
+const std::vector<Net> &ComponentLabel::outputNets() const
 {
-    return _output_wires;
+    return _output_nets;
 }
 
 void ComponentLabel::setParams(QString param_string)
@@ -178,14 +282,13 @@ void ComponentLabel::setParams(QString param_string)
 
 bool ComponentLabel::saveWire(Wire *wire, bool is_input, int idx)
 {
-    if (is_input)
+    if (!keepWire(wire, is_input, idx))
     {
-        if (_input_wires[idx] != nullptr)
-        {
-            return false;
-        }
-        _input_wires[idx] = wire;
+        return false;
+    }
 
+    if (is_input)
+    {
         std::pair<ComponentLabel *, int> output_info =
           wire->outputComponentInfo();
         static_cast<model::component::NInputComponent *>(_component_model)
@@ -193,35 +296,66 @@ bool ComponentLabel::saveWire(Wire *wire, bool is_input, int idx)
                       *(output_info.first->component_model()),
                       output_info.second);
     }
+
+    return true;
+}
+
+void ComponentLabel::removeWire(Wire *wire, bool is_input, int idx)
+{
+    if (is_input && wire != _input_wires[idx])
+    {
+        return;
+    }
+    dropWire(wire, is_input, idx);
+
+    if (is_input)
+    {
+        static_cast<model::component::NInputComponent *>(_component_model)
+          ->remove_input(idx);
+    }
+}
+
+bool ComponentLabel::keepWire(Wire *wire, bool is_input, int idx)
+{
+    if (is_input)
+    {
+        if (_input_wires[idx] != nullptr)
+        {
+            return false;
+        }
+        _input_wires[idx] = wire;
+    }
     else
     {
-        _output_wires[idx].push_back(wire);
+        _output_nets[idx].wires.push_back(wire);
     }
 
     return true;
 }
 
-void ComponentLabel::removeWire(Wire *wire, bool is_input, int idx)
+void ComponentLabel::dropWire(Wire *wire, bool is_input, int idx)
 {
     if (is_input)
     {
-        if (wire != _input_wires[idx])
+        if (wire == _input_wires[idx])
         {
-            return;
+            _input_wires[idx] = nullptr;
         }
-        _input_wires[idx] = nullptr;
-        static_cast<model::component::NInputComponent *>(_component_model)
-          ->remove_input(idx);
     }
     else
     {
-        _output_wires[idx].erase(std::remove(_output_wires[idx].begin(),
-                                             _output_wires[idx].end(),
-                                             wire),
-                                 _output_wires[idx].end());
+        std::vector<Wire *> &wires = _output_nets[idx].wires;
+        wires.erase(std::remove(wires.begin(), wires.end(), wire), wires.end());
     }
 }
 
+model::component::Component *ComponentLabel::releaseModel()
+{
+    model::component::Component *component_model = _component_model;
+    _component_model                             = nullptr;
+    return component_model;
+}
+
 void ComponentLabel::moveWires()
 {
     for (const auto &wire : _input_wires)
@@ -233,9 +367,9 @@ void ComponentLabel::moveWires()
         wire->reposition();
     }
 
-    for (const auto &output : _output_wires)
+    for (const auto &net : _output_nets)
     {
-        for (const auto &wire : output)
+        for (const auto &wire : net.wires)
         {
             wire->reposition();
         }
@@ -302,11 +436,15 @@ void ComponentLabel::mousePressEvent(QMouseEvent *ev)
         {
         case BUTTON:
             setResourceByIdx(1);
-            static_cast<model::input::Button *>(_component_model)->press();
+            emit simulationInput(
+              { _component_model, model::sim::InputEvent::PRESS, 0, 0 });
             break;
         case SWITCH:
             setResourceByIdx(!_resource_idx);
-            _component_model->set_params(std::to_string(_resource_idx));
+            emit simulationInput({ _component_model,
+                                   model::sim::InputEvent::SET,
+                                   static_cast<unsigned int>(_resource_idx),
+                                   0 });
             break;
         case KEYPAD:
         {
@@ -340,7 +478,8 @@ void ComponentLabel::mousePressEvent(QMouseEvent *ev)
                 break;
             }
             unsigned int key = 4 * row + col;
-            static_cast<model::input::Keypad *>(_component_model)->set_key(key);
+            emit simulationInput(
+              { _component_model, model::sim::InputEvent::KEY, key, 0 });
             setResourceByIdx(key + 1);
             break;
         }
@@ -379,7 +518,8 @@ void ComponentLabel::mouseReleaseEvent(QMouseEvent *ev)
         {
         case BUTTON:
             setResourceByIdx(0);
-            static_cast<model::input::Button *>(_component_model)->release();
+            emit simulationInput(
+              { _component_model, model::sim::InputEvent::RELEASE, 0, 0 });
             break;
         case KEYPAD:
             setResourceByIdx(0);
@@ -409,10 +549,89 @@ void ComponentLabel::mouseDoubleClickEvent(QMouseEvent *ev)
     }
 }
 
+void ComponentLabel::contextMenuEvent(QContextMenuEvent *ev)
+{
+    if (_current_tool != TOOL::SIMULATE)
+    {
+        ev->ignore();
+        return;
+    }
+    ev->accept();
+
+    QMenu menu(_design_area);
+
+    unsigned int n_evals = _component_model->n_evals();
+    // same conditions are offered for breaking and for running until
+    auto add_conditions = [this, n_evals](QMenu *cond_menu, bool run_until)
+    {
+        for (unsigned int out = 0; out < n_evals; ++out)
+        {
+            QMenu *out_menu = cond_menu;
+            if (n_evals > 1)
+            {
+                out_menu = cond_menu->addMenu("Output " + QString::number(out));
+            }
+
+            model::component::Component *component = _component_model;
+            const std::vector<std::pair<QString, model::watch::Watchpoint>>
+              watchpoints = {
+                  { "Rising Edge", model::watch::rising_edge(*component, out) },
+                  { "Falling Edge",
+                    model::watch::falling_edge(*component, out) },
+                  { "Any Edge", model::watch::any_edge(*component, out) },
+                  { "High",
+                    model::watch::level(*component, out, model::State::ONE) },
+                  { "Low",
+                    model::watch::level(*component, out, model::State::ZERO) },
+                  { "HiZ", model::watch::high_impedance(*component, out) }
+              };
+            for (const auto &[name, watchpoint] : watchpoints)
+            {
+                model::watch::Watchpoint wp = watchpoint;
+                connect(out_menu->addAction(name),
+                        &QAction::triggered,
+                        this,
+                        [this, wp, run_until]()
+                        {
+                            if (run_until)
+                            {
+                                emit runUntilRequested(wp);
+                            }
+                            else
+                            {
+                                emit watchpointRequested(wp);
+                            }
+                        });
+            }
+        }
+
+        if (n_evals > 1)
+        {
+            connect(cond_menu->addAction("Pattern..."),
+                    &QAction::triggered,
+                    this,
+                    [this, run_until]()
+                    { _setupPatternWatchpoint(run_until); });
+        }
+    };
+    add_conditions(menu.addMenu("Break On"), false);
+    add_conditions(menu.addMenu("Run Until"), true);
+
+    connect(menu.addAction("Clear Watchpoints"),
+            &QAction::triggered,
+            this,
+            [this]() { emit watchpointsCleared(this); });
+
+    menu.exec(ev->globalPos());
+}
+
 void ComponentLabel::move(int pos_x, int pos_y)
 {
-    QLabel::move(pos_x, pos_y);
+    _update();
+    _geometry.moveTo(pos_x, pos_y);
+    _update();
     moveWires();
+    emit positionChanged(this);
 }
 
 void ComponentLabel::cancelMove(ComponentLabel *component)
@@ -428,7 +647,7 @@ void ComponentLabel::_setupProperties()
     _properties_popup = new Properties(
       comp_type_to_name.at(_comp_type),
       resources::DOC_PATH + comp_type_to_doc_filename.at(_comp_type),
-      parentWidget());
+      _design_area);
 
     switch (_comp_type)
     {
@@ -524,17 +743,82 @@ void ComponentLabel::_setupProperties()
                 emit performPropertyUndoAction();
             });
 
-    QPoint w_pos = parentWidget()->mapToGlobal(pos());
-    _properties_popup->move(w_pos.x() + width(), w_pos.y());
+    QRect  view_geometry = viewGeometry();
+    QPoint w_pos = _design_area->mapToGlobal(view_geometry.topLeft());
+    _properties_popup->move(w_pos.x() + view_geometry.width(), w_pos.y());
     _properties_popup->show();
 }
 
+void ComponentLabel::_setupPatternWatchpoint(bool run_until)
+{
+    Properties *pattern_popup =
+      new Properties(run_until ? "Run Until Pattern" : "Break On Pattern",
+                     resources::DOC_PATH + "02 Simulation.html",
+                     _design_area);
+
+    unsigned int n_evals = _component_model->n_evals();
+    // entry is one character per output, in order: 0, 1 or Z
+    pattern_popup->addValueEntry(
+      "Pattern",
+      QString(n_evals, '0'),
+      [n_evals](QLineEdit *entry)
+      {
+          QString pattern = entry->text().trimmed().toUpper();
+          if (static_cast<unsigned int>(pattern.size()) != n_evals)
+          {
+              return QString();
+          }
+          for (const auto &c : pattern)
+          {
+              if (c != '0' && c != '1' && c != 'Z')
+              {
+                  return QString();
+              }
+          }
+          return pattern;
+      });
+
+    connect(pattern_popup,
+            &Properties::optionValue,
+            this,
+            [this, run_until](QString pattern, int /*group*/)
+            {
+                std::vector<model::watch::Probe> probes;
+                std::vector<model::State>        values;
+                for (int i = 0; i < pattern.size(); ++i)
+                {
+                    probes.push_back(
+                      { _component_model, static_cast<unsigned int>(i) });
+                    values.push_back(pattern[i] == 'Z'
+                                       ? model::State::HiZ
+                                       : static_cast<model::State>(
+                                           pattern[i].digitValue()));
+                }
+                model::watch::Watchpoint watchpoint =
+                  model::watch::pattern(probes, values);
+                if (run_until)
+                {
+                    emit runUntilRequested(watchpoint);
+                }
+                else
+                {
+                    emit watchpointRequested(watchpoint);
+                }
+            });
+
+    QRect  view_geometry = viewGeometry();
+    QPoint w_pos = _design_area->mapToGlobal(view_geometry.topLeft());
+    pattern_popup->move(w_pos.x() + view_geometry.width(), w_pos.y());
+    pattern_popup->show();
+}
+
 void ComponentLabel::changeMode(TOOL tool)
 {
     if (_current_tool == TOOL::SIMULATE && tool != TOOL::SIMULATE)
     {
         _component_model->set_params(_base_params);
         setResourceByIdx(_base_resource_idx);
+        _state = model::State::ZERO;
     }
 
     _current_tool = tool;
@@ -557,7 +841,8 @@ void ComponentLabel::checkRangeQuery(int min_x, int min_y, int max_x, int max_y)
     }
 }
 
-void ComponentLabel::wireSnap(ComponentLabel *wire_source, int x, int y)
+void ComponentLabel::wireSnap(ComponentLabel *wire_source, int x, int y,
+                              int leeway)
 {
     if (this == wire_source)
     {
@@ -565,9 +850,8 @@ void ComponentLabel::wireSnap(ComponentLabel *wire_source, int x, int y)
     }
     int obj_x = this->x();
     int obj_y = this->y();
-    if (!(obj_x - WIRE_SNAP_LEEWAY <= x && obj_y - WIRE_SNAP_LEEWAY <= y &&
-          x <= obj_x + width() + WIRE_SNAP_LEEWAY &&
-          y <= obj_y + height() + WIRE_SNAP_LEEWAY))
+    if (!(obj_x - leeway <= x && obj_y - leeway <= y &&
+          x <= obj_x + width() + leeway && y <= obj_y + height() + leeway))
     {
         return;
     }
@@ -593,36 +877,23 @@ void ComponentLabel::wireSnap(ComponentLabel *wire_source, int x, int y)
     emit wireSnapFound(this, target_x, target_y);
 }
 
-void ComponentLabel::evaluate()
+void ComponentLabel::evaluate(const model::sim::Snapshot &snapshot)
 {
+    _evaluateState(snapshot);
     try
     {
         switch (_comp_type)
         {
         case LED:
-            setResourceByIdx(_component_model->evaluate());
+            setResourceByIdx(getValue(snapshot, 0));
             break;
         case _7SEG_5IN:
-        {
-            std::vector<bool> evals(8);
-            for (int i = 0; i < 8; ++i)
-            {
-                evals[(7 + i) % 8] = _component_model->evaluate(i);
-            }
-            setResourceByIdx(resources::_7seg_5in_res_map.at(
-              utils::get_int_from_bools(evals)));
+            setResourceByIdx(
+              resources::_7seg_5in_res_table[_litSegments(snapshot)]);
             break;
-        }
         case _7SEG_8IN:
-        {
-            std::vector<bool> evals(8);
-            for (int i = 0; i < 8; ++i)
-            {
-                evals[(7 + i) % 8] = _component_model->evaluate(i);
-            }
-            setResourceByIdx(utils::get_int_from_bools(evals));
+            setResourceByIdx(_litSegments(snapshot));
             break;
-        }
         default:
             break;
         }
@@ -633,31 +904,58 @@ void ComponentLabel::evaluate()
     }
 }
 
-void ComponentLabel::resetResource()
+void ComponentLabel::resetResource(const model::sim::Snapshot &snapshot)
 {
     if (reset_resource_on_sim_components.find(_comp_type) !=
         reset_resource_on_sim_components.end())
     {
-        evaluate();
+        evaluate(snapshot);
+    }
+    else
+    {
+        _evaluateState(snapshot);
+    }
+}
+
+void ComponentLabel::_evaluateState(const model::sim::Snapshot &snapshot)
+{
+    if (_component_model->n_evals() > 0)
+    {
+        _state = getValue(snapshot, 0);
+    }
+}
+
+unsigned int
+  ComponentLabel::_litSegments(const model::sim::Snapshot &snapshot) const
+{
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        mask |= (getValue(snapshot, i) != model::State::ZERO) << ((7 + i) % 8);
     }
+    return mask;
 }
 
-void ComponentLabel::writeComponent(std::ofstream &file,
-                                    double         inverse_scale_factor,
-                                    double         inverse_translation_x,
-                                    double         inverse_translation_y)
+void ComponentLabel::writeComponent(std::ostream &file)
 {
-    QPoint native = getNativeCoordinates(inverse_scale_factor,
-                                         inverse_translation_x,
-                                         inverse_translation_y);
-    file << _component_model->id() << ';' << _component_model->ctype() << ';'
-         << (_current_tool == TOOL::SIMULATE ? _base_params
-                                             : _component_model->param_string())
-         << ';' << std::to_string(native.x()) << ','
-         << std::to_string(native.y()) << ';';
+    writeRecord(file,
+                *_component_model,
+                _current_tool == TOOL::SIMULATE
+                  ? _base_params
+                  : _component_model->param_string(),
+                x(),
+                y());
+}
+
+void ComponentLabel::writeRecord(std::ostream                      &file,
+                                 const model::component::Component &component,
+                                 const std::string &params, int x, int y)
+{
+    file << component.id() << ';' << component.ctype() << ';' << params << ';'
+         << std::to_string(x) << ',' << std::to_string(y) << ';';
 
     std::vector<std::pair<unsigned int, unsigned int>> input_ids =
-      _component_model->input_ids();
+      component.input_ids();
     for (size_t i = 0; i < input_ids.size(); ++i)
     {
         if (input_ids[i].first == std::numeric_limits<unsigned int>::max() &&
@@ -678,31 +976,54 @@ void ComponentLabel::writeComponent(std::ofstream &file,
     file << "\n";
 }
 
-model::State ComponentLabel::getValue(int output_idx)
+model::State ComponentLabel::getValue(const model::sim::Snapshot &snapshot,
+                                      int output_idx) const
 {
-    return _component_model->evaluate(output_idx);
+    return snapshot.value(_snapshot_slot, output_idx);
 }
 
-void ComponentLabel::positionTransformationApplied(int dx, int dy)
+void ComponentLabel::setSnapshotSlot(size_t slot)
 {
-    move(x() + dx, y() + dy);
+    _snapshot_slot = slot;
 }
 
-void ComponentLabel::scaleTransformationApplied(double size_scale,
-                                                double pos_scale,
-                                                double offset_x,
-                                                double offset_y)
+void ComponentLabel::evaluateNets(const model::sim::Snapshot &snapshot,
+                                  const QRect                &live_area)
 {
-    _scale = size_scale;
-    setResourceByIdx(_resource_idx);
-    _border->setPixmap(resources::getBorder(width(), height()));
-    _border->resize(width(), height());
-    // TODO: rounding can cause slight changes in native position when inverse
-    // transforming; possibly keep positions as doubles as well, and use those
-    // to inverse transform
-    QLabel::move(std::round(pos_scale * x() + offset_x),
-                 std::round(pos_scale * y() + offset_y));
-    moveWires();
+    for (size_t out = 0; out < _output_nets.size(); ++out)
+    {
+        Net &net = _output_nets[out];
+        if (net.wires.empty())
+        {
+            continue;
+        }
+        model::State state = getValue(snapshot, out);
+        if (state == net.state)
+        {
+            continue;
+        }
+        net.state = state;
+        for (const auto &wire : net.wires)
+        {
+            if (wire->bounds().intersects(live_area))
+            {
+                wire->setState(state);
+            }
+        }
+    }
+}
+
+void ComponentLabel::resetNets(const model::sim::Snapshot &snapshot)
+{
+    for (size_t out = 0; out < _output_nets.size(); ++out)
+    {
+        Net &net  = _output_nets[out];
+        net.state = getValue(snapshot, out);
+        for (const auto &wire : net.wires)
+        {
+            wire->setState(net.state);
+        }
+    }
 }
 }
 }
@@ -12,27 +12,46 @@ DesignArea::DesignArea(QWidget *parent) : QWidget(parent)
     _clipboard  = new Clipboard(this);
     QSettings settings("notTypecast", "LogicSim");
     _color_wires = settings.value("wire-color").toBool();
+
+    // new circuits get their own seed, kept from then on
+    std::random_device device;
+    _setSeed(static_cast<std::uint64_t>(device()) << 32 | device());
 }
 
 DesignArea::~DesignArea()
 {
+    // component models are deleted along with their labels, so the runner must
+    // stop first
+    delete _runner;
     delete _undo_stack;
     delete _clipboard;
+    // models of dormant records have no label to delete them
+    for (const auto &record : _records)
+    {
+        if (record.label == nullptr)
+        {
+            delete record.model;
+        }
+    }
 }
 
 void DesignArea::mousePressEvent(QMouseEvent *ev)
 {
+    ComponentLabel *component = _componentAt(ev->pos());
+    if (component != nullptr && _forwardMouseEvent(component, ev))
+    {
+        _mouse_grabber = component;
+        return;
+    }
+
     switch (_selected_tool)
     {
     case SELECT:
         _unselectAll();
-        _select_x = ev->x();
-        _select_y = ev->y();
-        for (int i = 0; i < 4; ++i)
-        {
-            _selection_border[i] = new QLabel(this);
-            _selection_border[i]->show();
-        }
+        _select_x       = ev->x();
+        _select_y       = ev->y();
+        _selecting      = true;
+        _selection_rect = QRect(_select_x, _select_y, 0, 0);
         break;
 
     case MOVE:
@@ -47,6 +66,9 @@ void DesignArea::mousePressEvent(QMouseEvent *ev)
         {
             break;
         }
+        // the command keeps referring to the wire's components
+        _pin(_marked_wire->component1());
+        _pin(_marked_wire->component2());
         DeleteWireCommand *delete_wire =
           new DeleteWireCommand(this, _marked_wire);
         _undo_stack->push(delete_wire);
@@ -74,6 +96,13 @@ void DesignArea::mousePressEvent(QMouseEvent *ev)
 
 void DesignArea::mouseDoubleClickEvent(QMouseEvent *ev)
 {
+    ComponentLabel *component = _componentAt(ev->pos());
+    if (component != nullptr && _forwardMouseEvent(component, ev))
+    {
+        _mouse_grabber = component;
+        return;
+    }
+
     switch (_selected_tool)
     {
     case MOVE:
@@ -87,20 +116,38 @@ void DesignArea::mouseDoubleClickEvent(QMouseEvent *ev)
 
 void DesignArea::mouseReleaseEvent(QMouseEvent *ev)
 {
+    if (_mouse_grabber != nullptr)
+    {
+        ComponentLabel *grabber = _mouse_grabber;
+        if (ev->buttons() == Qt::NoButton)
+        {
+            _mouse_grabber = nullptr;
+        }
+        if (_forwardMouseEvent(grabber, ev))
+        {
+            return;
+        }
+    }
+
     switch (_selected_tool)
     {
     case SELECT:
     {
-        for (int i = 0; i < 4; ++i)
-        {
-            delete _selection_border[i];
-            _selection_border[i] = nullptr;
-        }
+        _selecting = false;
+        update(_selection_rect.adjusted(0, 0, 1, 1));
         int min_x = std::min(_select_x, ev->x()),
             min_y = std::min(_select_y, ev->y());
         int max_x = std::max(_select_x, ev->x()),
             max_y = std::max(_select_y, ev->y());
-        emit rangeQuery(min_x, min_y, max_x, max_y);
+        QRect native =
+          _inv_view.mapRect(QRect(QPoint(min_x, min_y), QPoint(max_x, max_y)));
+        for (const auto &component : _componentsNear(native))
+        {
+            component->checkRangeQuery(native.left(),
+                                       native.top(),
+                                       native.right(),
+                                       native.bottom());
+        }
         break;
     }
 
@@ -114,37 +161,28 @@ void DesignArea::mouseReleaseEvent(QMouseEvent *ev)
 
 void DesignArea::mouseMoveEvent(QMouseEvent *ev)
 {
+    if (_mouse_grabber != nullptr && _forwardMouseEvent(_mouse_grabber, ev))
+    {
+        return;
+    }
+
     switch (_selected_tool)
     {
     case SELECT:
     {
-        if (_selection_border[0] == nullptr)
+        if (!_selecting)
         {
             return;
         }
-        int width  = std::abs(_select_x - ev->x()) + resources::LINE_THICKNESS,
-            height = std::abs(_select_y - ev->y());
-        QPixmap hline = resources::getLine(resources::HORIZONTAL, width);
-        QPixmap vline = resources::getLine(resources::VERTICAL, height);
-
         int min_x = std::min(_select_x, ev->x()),
             min_y = std::min(_select_y, ev->y());
+        int max_x = std::max(_select_x, ev->x()),
+            max_y = std::max(_select_y, ev->y());
 
-        _selection_border[0]->resize(resources::LINE_THICKNESS, height);
-        _selection_border[0]->setPixmap(vline);
-        _selection_border[0]->move(min_x, min_y);
-
-        _selection_border[1]->resize(resources::LINE_THICKNESS, height);
-        _selection_border[1]->setPixmap(vline);
-        _selection_border[1]->move(std::max(_select_x, ev->x()), min_y);
-
-        _selection_border[2]->resize(width, resources::LINE_THICKNESS);
-        _selection_border[2]->setPixmap(hline);
-        _selection_border[2]->move(min_x, min_y);
-
-        _selection_border[3]->resize(width, resources::LINE_THICKNESS);
-        _selection_border[3]->setPixmap(hline);
-        _selection_border[3]->move(min_x, std::max(_select_y, ev->y()));
+        // border is drawn one pixel past the bottom right of its rectangle
+        update(_selection_rect.adjusted(0, 0, 1, 1));
+        _selection_rect = QRect(min_x, min_y, max_x - min_x, max_y - min_y);
+        update(_selection_rect.adjusted(0, 0, 1, 1));
 
         break;
     }
@@ -152,15 +190,9 @@ void DesignArea::mouseMoveEvent(QMouseEvent *ev)
     case MOVE:
     case SIMULATE:
     {
-        double inv_scale_factor =
-          std::pow(INV_BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL);
-        int dx                  = ev->x() - _init_move_x;
-        int dy                  = ev->y() - _init_move_y;
-        _transformation.tx     += dx;
-        _transformation.ty     += dy;
-        _transformation.tx_inv -= inv_scale_factor * dx;
-        _transformation.ty_inv -= inv_scale_factor * dy;
-        emit transformPosition(dx, dy);
+        int dx = ev->x() - _init_move_x;
+        int dy = ev->y() - _init_move_y;
+        _setView(_view.dx() + dx, _view.dy() + dy);
         _init_move_x = ev->x();
         _init_move_y = ev->y();
         break;
@@ -168,14 +200,26 @@ void DesignArea::mouseMoveEvent(QMouseEvent *ev)
 
     case INSERT:
     {
-        int x = ev->x() - _selected_components[0]->width() / 2;
-        int y = ev->y() - _selected_components[0]->height() / 2;
-        _selected_components[0]->move(x, y);
+        int x, y;
+        std::tie(x, y) = _toNativeCoordinates(ev->x(), ev->y());
+        _selected_components[0]->move(
+          x - _selected_components[0]->width() / 2,
+          y - _selected_components[0]->height() / 2);
         break;
     }
 
     case WIRE_REMOVE:
-        emit wireProximityCheck(ev->x(), ev->y());
+    {
+        int x, y;
+        std::tie(x, y) = _toNativeCoordinates(ev->x(), ev->y());
+        // threshold is a distance on the screen
+        double threshold = WIRE_REMOVE_DISTANCE_THRESHOLD / getScale();
+        int    range     = static_cast<int>(std::ceil(threshold));
+        for (const auto &wire : _wiresNear(
+               QRect(x - range, y - range, 2 * range + 1, 2 * range + 1)))
+        {
+            wire->checkProximity(x, y, threshold);
+        }
         if (!_proximity_wire_dist.empty())
         {
             Wire *closest_wire = _proximity_wire_dist[0].first;
@@ -215,6 +259,7 @@ void DesignArea::mouseMoveEvent(QMouseEvent *ev)
         }
 
         break;
+    }
 
     default:
         break;
@@ -240,6 +285,168 @@ void DesignArea::wheelEvent(QWheelEvent *ev)
     }
 }
 
+void DesignArea::contextMenuEvent(QContextMenuEvent *ev)
+{
+    ComponentLabel *component = _componentAt(ev->pos());
+    if (component != nullptr)
+    {
+        // actions of the menu refer to the component
+        if (_selected_tool == TOOL::SIMULATE)
+        {
+            _pin(component);
+        }
+        QPoint pos = _inv_view.map(QPointF(ev->pos())).toPoint();
+        QContextMenuEvent local(ev->reason(),
+                                pos - component->pos(),
+                                ev->globalPos(),
+                                ev->modifiers());
+        component->contextMenuEvent(&local);
+        if (local.isAccepted())
+        {
+            return;
+        }
+    }
+    ev->ignore();
+}
+
+void DesignArea::paintEvent(QPaintEvent *ev)
+{
+    QPainter     painter(this);
+    const QRect &area        = ev->rect();
+    QRect        native_area = _toNativeRect(area);
+
+    // only items near the repainted area are visited
+    std::vector<ComponentLabel *> components = _componentsNear(native_area);
+    std::sort(components.begin(),
+              components.end(),
+              [](ComponentLabel *a, ComponentLabel *b)
+              { return a->stackingOrder() < b->stackingOrder(); });
+    bool low_detail = _lowDetail();
+    for (const auto &component : components)
+    {
+        if (!component->isHidden() &&
+            component->viewGeometry().intersects(area))
+        {
+            if (low_detail)
+            {
+                component->paintLowDetail(painter);
+            }
+            else
+            {
+                component->paint(painter);
+            }
+        }
+    }
+
+    // wires are plain rectangles (or lines, in low detail), so they are drawn
+    // in one call per color
+    std::vector<QRect> wire_rects[3];
+    std::vector<QLine> wire_lines[3];
+    auto               add_wire = [&](const Wire *wire)
+    {
+        if (low_detail)
+        {
+            wire_lines[wire->state()].push_back(wire->viewLine());
+        }
+        else
+        {
+            wire->addSegments(wire_rects[wire->state()]);
+        }
+    };
+    for (const auto &wire : _wiresNear(native_area))
+    {
+        if (!wire->isHidden() && wire->bounds().intersects(native_area))
+        {
+            add_wire(wire);
+        }
+    }
+    if (_wire != nullptr)
+    {
+        add_wire(_wire);
+    }
+
+    for (int state = model::State::ZERO; state <= model::State::HiZ; ++state)
+    {
+        QColor color =
+          resources::getWireColor(static_cast<model::State>(state));
+        painter.setPen(low_detail ? QPen(color) : QPen(Qt::NoPen));
+        painter.setBrush(color);
+        painter.drawRects(wire_rects[state].data(),
+                          static_cast<int>(wire_rects[state].size()));
+        painter.drawLines(wire_lines[state].data(),
+                          static_cast<int>(wire_lines[state].size()));
+    }
+
+    if (_marked_wire != nullptr)
+    {
+        _marked_wire->paintMarkings(painter);
+    }
+
+    if (_selecting)
+    {
+        painter.setPen(resources::getLineColor());
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(_selection_rect);
+    }
+}
+
+void DesignArea::resizeEvent(QResizeEvent * /*ev*/)
+{
+    _updateLiveArea();
+}
+
+ComponentLabel *DesignArea::_componentAt(const QPoint &pos) const
+{
+    // last connected component is drawn on top
+    ComponentLabel *top = nullptr;
+    for (const auto &component :
+         _componentsNear(_toNativeRect(QRect(pos, pos))))
+    {
+        if (!component->isHidden() && component->viewGeometry().contains(pos) &&
+            (top == nullptr ||
+             component->stackingOrder() > top->stackingOrder()))
+        {
+            top = component;
+        }
+    }
+    return top;
+}
+
+bool DesignArea::_forwardMouseEvent(ComponentLabel *component, QMouseEvent *ev)
+{
+    QMouseEvent local(ev->type(),
+                      _inv_view.map(ev->localPos()) -
+                        QPointF(component->pos()),
+                      ev->windowPos(),
+                      ev->screenPos(),
+                      ev->button(),
+                      ev->buttons(),
+                      ev->modifiers());
+    switch (ev->type())
+    {
+    case QEvent::MouseButtonPress:
+        component->mousePressEvent(&local);
+        break;
+    case QEvent::MouseButtonRelease:
+        component->mouseReleaseEvent(&local);
+        return local.isAccepted();
+    case QEvent::MouseButtonDblClick:
+        component->mouseDoubleClickEvent(&local);
+        break;
+    case QEvent::MouseMove:
+        component->mouseMoveEvent(&local);
+        return local.isAccepted();
+    default:
+        return false;
+    }
+    // components that were pressed (wire source, simulation input) are kept
+    if (local.isAccepted())
+    {
+        _pin(component);
+    }
+    return local.isAccepted();
+}
+
 void DesignArea::setStatusBar(QStatusBar *status_bar)
 {
     _status_bar  = status_bar;
@@ -250,8 +457,18 @@ void DesignArea::setStatusBar(QStatusBar *status_bar)
 
 void DesignArea::setFrequency(unsigned int freq)
 {
+    if (freq == _freq)
+    {
+        return;
+    }
     ChangeSimulationPropertiesCommand *sim_prop_command =
-      new ChangeSimulationPropertiesCommand(this, _freq, freq);
+      new ChangeSimulationPropertiesCommand(this,
+                                            _freq,
+                                            _max_speed,
+                                            _seed,
+                                            freq,
+                                            _max_speed,
+                                            _seed);
     _undo_stack->push(sim_prop_command);
     emit newUndoActionPerformed(false, true, false);
 }
@@ -261,12 +478,139 @@ unsigned int DesignArea::frequency() const
     return _freq;
 }
 
+void DesignArea::setMaxSpeed(bool max_speed)
+{
+    if (max_speed == _max_speed)
+    {
+        return;
+    }
+    ChangeSimulationPropertiesCommand *sim_prop_command =
+      new ChangeSimulationPropertiesCommand(this,
+                                            _freq,
+                                            _max_speed,
+                                            _seed,
+                                            _freq,
+                                            max_speed,
+                                            _seed);
+    _undo_stack->push(sim_prop_command);
+    emit newUndoActionPerformed(false, true, false);
+}
+
+bool DesignArea::maxSpeed() const
+{
+    return _max_speed;
+}
+
+std::uint64_t DesignArea::seed() const
+{
+    return _seed;
+}
+
+void DesignArea::setSeed(std::uint64_t seed)
+{
+    if (seed == _seed)
+    {
+        return;
+    }
+    ChangeSimulationPropertiesCommand *sim_prop_command =
+      new ChangeSimulationPropertiesCommand(this,
+                                            _freq,
+                                            _max_speed,
+                                            _seed,
+                                            _freq,
+                                            _max_speed,
+                                            seed);
+    _undo_stack->push(sim_prop_command);
+    emit newUndoActionPerformed(false, true, false);
+}
+
+void DesignArea::_setSeed(std::uint64_t seed)
+{
+    _seed = seed;
+    if (_runner == nullptr)
+    {
+        _circuit_model.set_seed(seed);
+        return;
+    }
+    _runner->exclusive([seed](model::circuit::Circuit &circuit)
+                       { circuit.set_seed(seed); });
+}
+
+unsigned int DesignArea::_runnerFrequency() const
+{
+    return _max_speed ? model::sim::Runner::MAX_SPEED : _freq;
+}
+
+void DesignArea::_setTicksLabel(const model::sim::Snapshot &snapshot)
+{
+    _ticks_label_text = "Ticks: " + QString::number(snapshot.tick);
+    if (snapshot.idle)
+    {
+        _ticks_label_text += " (settled)";
+    }
+    else if (snapshot.rate > 0)
+    {
+        _ticks_label_text += " (" + _formatFrequency(snapshot.rate);
+        _ticks_label_text += _max_speed
+                               ? ", max speed)"
+                               : " of " + _formatFrequency(_freq) + ")";
+    }
+    _ticks_label->setText(_ticks_label_text);
+}
+
+QString DesignArea::_formatFrequency(double freq)
+{
+    if (freq >= 1e9)
+    {
+        return QString::number(freq / 1e9, 'f', 2) + " GHz";
+    }
+    if (freq >= 1e6)
+    {
+        return QString::number(freq / 1e6, 'f', 2) + " MHz";
+    }
+    if (freq >= 1e3)
+    {
+        return QString::number(freq / 1e3, 'f', 2) + " kHz";
+    }
+    return QString::number(freq, 'f', 0) + " Hz";
+}
+
+void DesignArea::_showStepProgress()
+{
+    std::uint64_t left = _runner->steps();
+    if (left == 0)
+    {
+        _status_bar->showMessage(
+          "Ran " + QString::number(_steps_requested) + " ticks", 5000);
+        _steps_requested = 0;
+        return;
+    }
+
+    std::uint64_t done = _steps_requested - left;
+    _status_bar->showMessage(QString("Running ticks: %1% (%2 of %3)")
+                               .arg(done * 100 / _steps_requested)
+                               .arg(done)
+                               .arg(_steps_requested));
+}
+
+void DesignArea::_resumeUpdates()
+{
+    if (_timer != nullptr && !_paused_state && !_timer->isActive())
+    {
+        _timer->start();
+    }
+}
+
 void DesignArea::pauseState()
 {
     if (_selected_tool == TOOL::SIMULATE)
     {
-        _state_sim_paused = !_timer->isActive();
+        // status bar is shared between tabs, so steps aren't left running
+        cancelSteps();
+        _state_sim_paused = _runner->paused();
         pauseSimulation();
+        // status bar is shared between tabs
+        _timer->stop();
     }
 
     _paused_state = true;
@@ -292,6 +636,7 @@ bool DesignArea::continueState()
     }
     if (_selected_tool == TOOL::SIMULATE)
     {
+        _timer->start();
         if (!_state_sim_paused)
         {
             continueSimulation();
@@ -305,7 +650,20 @@ bool DesignArea::continueState()
 void DesignArea::_connectComponent(ComponentLabel *label, bool first_time)
 {
     _circuit_model.add_component(*(label->component_model()));
+    label->setStackingOrder(++_stacking_order);
+    _connectLabel(label, first_time);
+}
+
+void DesignArea::_disconnectComponent(ComponentLabel *label)
+{
+    _circuit_model.remove_component(*(label->component_model()));
+    _disconnectLabel(label);
+}
+
+void DesignArea::_connectLabel(ComponentLabel *label, bool first_time)
+{
     _components.push_back(label);
+    _component_index.insert(label, label->geometry());
 
     if (first_time)
     {
@@ -318,14 +676,6 @@ void DesignArea::_connectComponent(ComponentLabel *label, bool first_time)
                 &DesignArea::resetResource,
                 label,
                 &ComponentLabel::resetResource);
-        connect(this,
-                &DesignArea::transformPosition,
-                label,
-                &ComponentLabel::positionTransformationApplied);
-        connect(this,
-                &DesignArea::transformScale,
-                label,
-                &ComponentLabel::scaleTransformationApplied);
         connect(this,
                 &DesignArea::cancelMove,
                 label,
@@ -341,10 +691,10 @@ void DesignArea::_connectComponent(ComponentLabel *label, bool first_time)
             &ComponentLabel::moveFinished,
             this,
             &DesignArea::finishMove);
-    connect(this,
-            &DesignArea::rangeQuery,
-            label,
-            &ComponentLabel::checkRangeQuery);
+    connect(label,
+            &ComponentLabel::positionChanged,
+            this,
+            &DesignArea::componentPositionChanged);
     connect(label,
             &ComponentLabel::selected_nocheck,
             this,
@@ -354,7 +704,6 @@ void DesignArea::_connectComponent(ComponentLabel *label, bool first_time)
             this,
             &DesignArea::getWireSource);
     connect(label, &ComponentLabel::wireMoved, this, &DesignArea::moveWireDest);
-    connect(this, &DesignArea::wireSnap, label, &ComponentLabel::wireSnap);
     connect(label,
             &ComponentLabel::wireSnapFound,
             this,
@@ -363,21 +712,45 @@ void DesignArea::_connectComponent(ComponentLabel *label, bool first_time)
             &ComponentLabel::wireReleased,
             this,
             &DesignArea::setWireDest);
-    connect(this, &DesignArea::evaluate, label, &ComponentLabel::evaluate);
     connect(this,
-            &DesignArea::writeComponent,
+            &DesignArea::resetWireResource,
             label,
-            &ComponentLabel::writeComponent);
+            &ComponentLabel::resetNets);
     connect(label,
             &ComponentLabel::performPropertyUndoAction,
             this,
             &DesignArea::propertyUndoActionPerformed);
+    connect(label,
+            &ComponentLabel::watchpointRequested,
+            this,
+            &DesignArea::addWatchpoint);
+    connect(label,
+            &ComponentLabel::watchpointsCleared,
+            this,
+            &DesignArea::clearWatchpoints);
+    connect(label,
+            &ComponentLabel::runUntilRequested,
+            this,
+            &DesignArea::runUntil);
+    connect(label,
+            &ComponentLabel::simulationInput,
+            this,
+            &DesignArea::postInput);
 }
 
-void DesignArea::_disconnectComponent(ComponentLabel *label)
+void DesignArea::_disconnectLabel(ComponentLabel *label)
 {
-    _circuit_model.remove_component(*(label->component_model()));
     _components.erase(std::find(_components.begin(), _components.end(), label));
+    _component_index.remove(label);
+    if (_mouse_grabber == label)
+    {
+        _mouse_grabber = nullptr;
+    }
+    // labels of records may be destroyed by zooming while a wire is drawn
+    if (_wire_snap_closest.component == label)
+    {
+        _wire_snap_closest.component = nullptr;
+    }
 
     disconnect(label,
                &ComponentLabel::selected,
@@ -391,10 +764,10 @@ void DesignArea::_disconnectComponent(ComponentLabel *label)
                &ComponentLabel::moveFinished,
                this,
                &DesignArea::finishMove);
-    disconnect(this,
-               &DesignArea::rangeQuery,
-               label,
-               &ComponentLabel::checkRangeQuery);
+    disconnect(label,
+               &ComponentLabel::positionChanged,
+               this,
+               &DesignArea::componentPositionChanged);
     disconnect(label,
                &ComponentLabel::selected_nocheck,
                this,
@@ -407,7 +780,6 @@ void DesignArea::_disconnectComponent(ComponentLabel *label)
                &ComponentLabel::wireMoved,
                this,
                &DesignArea::moveWireDest);
-    disconnect(this, &DesignArea::wireSnap, label, &ComponentLabel::wireSnap);
     disconnect(label,
                &ComponentLabel::wireSnapFound,
                this,
@@ -416,50 +788,61 @@ void DesignArea::_disconnectComponent(ComponentLabel *label)
                &ComponentLabel::wireReleased,
                this,
                &DesignArea::setWireDest);
-    disconnect(this, &DesignArea::evaluate, label, &ComponentLabel::evaluate);
     disconnect(this,
-               &DesignArea::writeComponent,
+               &DesignArea::resetWireResource,
                label,
-               &ComponentLabel::writeComponent);
+               &ComponentLabel::resetNets);
     disconnect(label,
                &ComponentLabel::performPropertyUndoAction,
                this,
                &DesignArea::propertyUndoActionPerformed);
+    disconnect(label,
+               &ComponentLabel::watchpointRequested,
+               this,
+               &DesignArea::addWatchpoint);
+    disconnect(label,
+               &ComponentLabel::watchpointsCleared,
+               this,
+               &DesignArea::clearWatchpoints);
+    disconnect(label,
+               &ComponentLabel::runUntilRequested,
+               this,
+               &DesignArea::runUntil);
+    disconnect(label,
+               &ComponentLabel::simulationInput,
+               this,
+               &DesignArea::postInput);
 }
 
 void DesignArea::_connectWire(Wire *wire, bool first_time)
 {
+    _wires.insert(wire);
+    _wire_index.insert(wire, wire->bounds());
     if (first_time)
     {
         connect(this, &DesignArea::modeChanged, wire, &Wire::changeMode);
-        connect(this,
-                &DesignArea::transformScale,
-                wire,
-                &Wire::scaleTransformationApplied);
     }
-    connect(this, &DesignArea::wireProximityCheck, wire, &Wire::checkProximity);
     connect(wire,
             &Wire::proximityConfirmed,
             this,
             &DesignArea::getProximityWireDistance);
-    connect(this, &DesignArea::evaluateWire, wire, &Wire::evaluate);
     connect(this, &DesignArea::disableColorWires, wire, &Wire::uncolor);
-    connect(this, &DesignArea::resetWireResource, wire, &Wire::updateColorWire);
 }
 
 void DesignArea::_disconnectWire(Wire *wire)
 {
-    disconnect(this,
-               &DesignArea::wireProximityCheck,
-               wire,
-               &Wire::checkProximity);
+    _wires.erase(wire);
+    _wire_index.remove(wire);
+    if (_marked_wire == wire)
+    {
+        _marked_wire->unmarkForDeletion();
+        _marked_wire = nullptr;
+    }
     disconnect(wire,
                &Wire::proximityConfirmed,
                this,
                &DesignArea::getProximityWireDistance);
-    disconnect(this, &DesignArea::evaluateWire, wire, &Wire::evaluate);
     disconnect(this, &DesignArea::disableColorWires, wire, &Wire::uncolor);
-    disconnect(this, &DesignArea::resetResource, wire, &Wire::updateColorWire);
 }
 
 void DesignArea::addSelected(ComponentLabel *component, bool ctrl)
@@ -498,6 +881,8 @@ void DesignArea::addSelected(ComponentLabel *component, bool ctrl)
 
 void DesignArea::addSelected_nocheck(ComponentLabel *component)
 {
+    // selected components may be moved, deleted or copied, with their wires
+    _pin(component);
     _selected_components.push_back(component);
 
     component->showBorder();
@@ -557,10 +942,54 @@ void DesignArea::finishMove()
                                 _undo_stack->canRedo());
 }
 
+void DesignArea::componentPositionChanged(ComponentLabel *component)
+{
+    _indexComponent(component);
+}
+
+void DesignArea::_indexComponent(ComponentLabel *label)
+{
+    _component_index.insert(label, label->geometry());
+
+    for (const auto &wire : label->inputWires())
+    {
+        if (wire != nullptr && _wires.find(wire) != _wires.end())
+        {
+            _wire_index.insert(wire, wire->bounds());
+        }
+    }
+
+    for (const auto &net : label->outputNets())
+    {
+        for (const auto &wire : net.wires)
+        {
+            if (_wires.find(wire) != _wires.end())
+            {
+                _wire_index.insert(wire, wire->bounds());
+            }
+        }
+    }
+}
+
+std::vector<ComponentLabel *>
+DesignArea::_componentsNear(const QRect &rect) const
+{
+    std::vector<ComponentLabel *> components;
+    _component_index.query(rect, components);
+    return components;
+}
+
+std::vector<Wire *> DesignArea::_wiresNear(const QRect &rect) const
+{
+    std::vector<Wire *> wires;
+    _wire_index.query(rect, wires);
+    return wires;
+}
+
 void DesignArea::getWireSource(ComponentLabel *component, int dx, int dy)
 {
     _wire_snap_closest.component = nullptr;
-    _wire                        = new Wire(getScale(), this);
+    _wire                        = new Wire(_view, this);
     bool set                     = _wire->setComponent1(component, dx, dy);
     if (!set)
     {
@@ -576,9 +1005,15 @@ void DesignArea::moveWireDest(int dx, int dy)
         return;
     }
     _wire_snap_positions.clear();
-    int  x = dx + _wire->getComponent1x();
-    int  y = dy + _wire->getComponent1y();
-    emit wireSnap(_wire->component1(), x, y);
+    int x = dx + _wire->getComponent1x();
+    int y = dy + _wire->getComponent1y();
+    // leeway is a distance on the screen
+    int leeway = static_cast<int>(std::ceil(WIRE_SNAP_LEEWAY / getScale()));
+    for (const auto &component : _componentsNear(
+           QRect(x - leeway, y - leeway, 2 * leeway + 1, 2 * leeway + 1)))
+    {
+        component->wireSnap(_wire->component1(), x, y, leeway);
+    }
     if (_wire_snap_positions.empty())
     {
         _wire_snap_closest.component = nullptr;
@@ -613,11 +1048,18 @@ void DesignArea::setWireDest()
     ComponentLabel *dest_component = _wire_snap_closest.component;
     if (_wire == nullptr || dest_component == nullptr)
     {
+        if (_wire != nullptr)
+        {
+            // clear wire drawn so far
+            _wire->hide();
+        }
         delete _wire;
         _wire = nullptr;
         return;
     }
 
+    // its inputs must all be wired to tell whether the wire can connect
+    _pin(dest_component);
     _wire->setComponent2(dest_component,
                          _wire_snap_closest.x - dest_component->x(),
                          _wire_snap_closest.y - dest_component->y());
@@ -633,30 +1075,242 @@ void DesignArea::setWireDest()
     }
     else
     {
+        // wire is now drawn as part of the circuit
+        _wire = nullptr;
         emit newUndoActionPerformed(false,
                                     _undo_stack->canUndo(),
                                     _undo_stack->canRedo());
     }
 }
 
-void DesignArea::executeTick(unsigned int ticks)
+void DesignArea::updateSimulation()
 {
-    for (unsigned int i = 0; i < ticks; ++i)
+    if (!_runner->update_snapshot())
     {
-        _circuit_model.tick();
+        return;
     }
-    _ticks_label_text =
-      "Ticks: " + QString::number(_circuit_model.total_ticks());
-    _ticks_label->setText(_ticks_label_text);
-    emit evaluate();
-    if (_color_wires)
+    const model::sim::Snapshot &snapshot = _runner->snapshot();
+
+    _setTicksLabel(snapshot);
+    if (_steps_requested != 0)
     {
-        emit evaluateWire();
+        _showStepProgress();
     }
-}
-
-TOOL DesignArea::mode() const
-{
+    // labels catch up once the run ends
+    if (_running_until)
+    {
+        if (_steps_requested == 0)
+        {
+            _endRunUntil();
+        }
+        return;
+    }
+    bool low_detail = _lowDetail();
+    // a full repaint is cheaper than tracking many small dirty areas
+    if (_runner->changed().size() > FULL_UPDATE_THRESHOLD)
+    {
+        update();
+    }
+    for (const auto &idx : _runner->changed())
+    {
+        // components without a label are evaluated once it is created
+        ComponentLabel *label = _simulated_labels[idx];
+        if (label == nullptr)
+        {
+            continue;
+        }
+        if (label->geometry().intersects(_live_area))
+        {
+            label->evaluate(snapshot);
+            // boxes are colored by state, which changes without the image
+            if (low_detail)
+            {
+                update(label->viewGeometry());
+            }
+        }
+        // wires may be in view even if their source component isn't
+        if (_color_wires)
+        {
+            label->evaluateNets(snapshot, _live_area);
+        }
+    }
+
+    // runner has already paused itself
+    if (snapshot.n_triggers != _n_triggers)
+    {
+        _n_triggers = snapshot.n_triggers;
+        _status_bar->showMessage("Watchpoint triggered at tick " +
+                                   QString::number(snapshot.tick),
+                                 5000);
+        emit simulationPaused();
+    }
+
+    // the runner publishes again once woken up, which restarts the timer
+    if (snapshot.idle)
+    {
+        _timer->stop();
+    }
+}
+
+void DesignArea::addWatchpoint(model::watch::Watchpoint watchpoint)
+{
+    if (_runner == nullptr)
+    {
+        _circuit_model.add_watchpoint(watchpoint);
+        return;
+    }
+    _runner->exclusive([&watchpoint](model::circuit::Circuit &circuit)
+                       { circuit.add_watchpoint(watchpoint); });
+    _resumeUpdates();
+}
+
+void DesignArea::clearWatchpoints(ComponentLabel *component)
+{
+    model::component::Component *component_model =
+      component->component_model();
+    if (_runner == nullptr)
+    {
+        _circuit_model.remove_watchpoints(*component_model);
+        return;
+    }
+    // a run until a condition on the component has nothing left to wait for
+    bool condition_cleared = false;
+    _runner->exclusive(
+      [this, component_model, &condition_cleared](
+        model::circuit::Circuit &circuit)
+      {
+          circuit.remove_watchpoints(*component_model);
+          condition_cleared =
+            _running_until && !circuit.has_watchpoint(_until_watchpoint);
+      });
+    if (condition_cleared)
+    {
+        cancelSteps();
+    }
+    _resumeUpdates();
+}
+
+void DesignArea::runUntil(model::watch::Watchpoint condition)
+{
+    if (_runner == nullptr || _running_until)
+    {
+        return;
+    }
+
+    Properties *until_popup = new Properties("Run Until", this);
+    until_popup->addValueEntry(
+      "Tick limit",
+      QString::number(_until_limit),
+      [](QLineEdit *entry)
+      {
+          bool          ok;
+          std::uint64_t val = entry->text().toULongLong(&ok);
+          if (!ok || val == 0)
+          {
+              return QString();
+          }
+          return QString::number(val);
+      });
+
+    connect(until_popup,
+            &Properties::optionValue,
+            this,
+            [this, condition](QString value, int /*group*/)
+            {
+                // simulation may have been stopped meanwhile
+                if (_runner == nullptr || _running_until)
+                {
+                    return;
+                }
+                _until_limit = value.toULongLong();
+                _startRunUntil(condition, _until_limit);
+            });
+
+    QSize popup_size = until_popup->sizeHint();
+    until_popup->move(mapToGlobal(rect().center()) -
+                      QPoint(popup_size.width() / 2, popup_size.height() / 2));
+    until_popup->show();
+}
+
+void DesignArea::_startRunUntil(const model::watch::Watchpoint &condition,
+                                std::uint64_t                   max_ticks)
+{
+    if (!_runner->paused())
+    {
+        pauseSimulation();
+        emit simulationPaused();
+    }
+
+    _runner->exclusive(
+      [this, &condition](model::circuit::Circuit &circuit)
+      { _until_watchpoint = circuit.add_watchpoint(condition); });
+    _running_until = true;
+    // steps run as fast as possible, and stop once a watchpoint fires
+    runTicks(max_ticks);
+}
+
+void DesignArea::_endRunUntil()
+{
+    _running_until = false;
+
+    // waits for the runner to finish its last batch, so the snapshot it
+    // publishes tells whether the condition fired
+    // the condition is gone if watchpoints of its components were cleared
+    unsigned int handle = _until_watchpoint;
+    _runner->exclusive(
+      [handle](model::circuit::Circuit &circuit)
+      {
+          if (circuit.has_watchpoint(handle))
+          {
+              circuit.remove_watchpoint(handle);
+          }
+      });
+
+    _runner->update_snapshot();
+    const model::sim::Snapshot &snapshot = _runner->snapshot();
+    _setTicksLabel(snapshot);
+    update();
+    emit resetResource(snapshot);
+    if (_color_wires)
+    {
+        emit resetWireResource(snapshot);
+    }
+
+    const std::vector<unsigned int> &handles = snapshot.triggered;
+    bool triggered = snapshot.n_triggers != _n_triggers;
+    bool met       = triggered &&
+               std::find(handles.begin(), handles.end(), handle) !=
+                 handles.end();
+    _n_triggers = snapshot.n_triggers;
+
+    QString tick = QString::number(snapshot.tick);
+    if (met)
+    {
+        _status_bar->showMessage("Condition met at tick " + tick, 5000);
+    }
+    else if (triggered)
+    {
+        _status_bar->showMessage("Watchpoint triggered at tick " + tick, 5000);
+    }
+    else
+    {
+        _status_bar->showMessage("Condition not met by tick " + tick, 5000);
+    }
+}
+
+void DesignArea::postInput(model::sim::InputEvent event)
+{
+    if (_runner == nullptr)
+    {
+        return;
+    }
+    event.tick = _runner->snapshot().tick;
+    _runner->post(event);
+    _resumeUpdates();
+}
+
+TOOL DesignArea::mode() const
+{
     return _selected_tool;
 }
 
@@ -679,18 +1333,9 @@ bool DesignArea::setMode(TOOL tool, COMPONENT comp_type, int res_idx)
             component->hideBorder();
         }
 
-        if (_timer == nullptr)
+        if (_runner == nullptr)
         {
             _ticks_label_text = "Ticks: 0";
-            _timer            = new QTimer(this);
-            connect(_timer,
-                    &QTimer::timeout,
-                    this,
-                    [this]()
-                    {
-                        executeTick();
-                    }); // need lambda because of executeTick's default argument
-            _timer->start(1000 / _freq);
         }
         _ticks_label->show();
         _ticks_label->setText(_ticks_label_text);
@@ -704,22 +1349,75 @@ bool DesignArea::setMode(TOOL tool, COMPONENT comp_type, int res_idx)
         setMouseTracking(false);
         if (_marked_wire != nullptr)
         {
+            _marked_wire->unmarkForDeletion();
             _marked_wire = nullptr;
         }
     }
 
     _selected_tool = tool;
+    // wires and components may all change appearance
+    update();
     emit modeChanged(tool);
 
     // emitted after modeChanged, so components correctly save base resource
     // index
+    // runner is also created after, since component models may only be
+    // accessed through it while it exists
     if (_selected_tool == TOOL::SIMULATE)
     {
-        emit resetResource();
+        bool start = _runner == nullptr;
+        if (start)
+        {
+            _runner =
+              new model::sim::Runner(_circuit_model, _runnerFrequency());
+            _n_triggers = 0;
+
+            std::unordered_map<model::component::Component *, ComponentLabel *>
+              labels;
+            for (const auto &label : _components)
+            {
+                label->setSnapshotSlot(
+                  _runner->slot(*(label->component_model())));
+                labels[label->component_model()] = label;
+            }
+            std::unordered_map<model::component::Component *, size_t> records;
+            for (size_t i = 0; i < _records.size(); ++i)
+            {
+                records[_records[i].model] = i;
+            }
+            _simulated_labels.clear();
+            for (const auto &component : _circuit_model.components())
+            {
+                auto record = records.find(component);
+                if (record != records.end())
+                {
+                    _records[record->second].simulated_idx =
+                      _simulated_labels.size();
+                }
+                auto label = labels.find(component);
+                _simulated_labels.push_back(
+                  label != labels.end() ? label->second : nullptr);
+            }
+
+            _timer = new QTimer(this);
+            connect(_timer,
+                    &QTimer::timeout,
+                    this,
+                    &DesignArea::updateSimulation);
+            _timer->start(FRAME_INTERVAL);
+        }
+
+        _runner->update_snapshot();
+        emit resetResource(_runner->snapshot());
 
         if (_color_wires)
         {
-            emit resetWireResource();
+            emit resetWireResource(_runner->snapshot());
+        }
+
+        if (start)
+        {
+            _runner->resume();
         }
     }
 
@@ -730,6 +1428,12 @@ void DesignArea::stopSimulationMode()
 {
     delete _timer;
     _timer = nullptr;
+    delete _runner;
+    _runner = nullptr;
+    _simulated_labels.clear();
+    _steps_requested = 0;
+    _running_until   = false;
+    _circuit_model.clear_watchpoints();
     _circuit_model.reset();
     _ticks_label->setText("");
     _ticks_label->hide();
@@ -744,27 +1448,59 @@ void DesignArea::stopSimulationMode()
 
 void DesignArea::pauseSimulation()
 {
-    _timer->stop();
+    _runner->pause();
+    _resumeUpdates();
 }
 
 void DesignArea::stepSimulation()
 {
-    executeTick(_freq);
+    runTicks(_freq);
+}
+
+void DesignArea::runTicks(std::uint64_t ticks)
+{
+    if (!_runner->paused())
+    {
+        return;
+    }
+    _runner->step(ticks);
+    _steps_requested += ticks;
+    _resumeUpdates();
+}
+
+void DesignArea::cancelSteps()
+{
+    if (_steps_requested == 0)
+    {
+        return;
+    }
+    // pausing also drops the remaining steps
+    _runner->pause();
+    _steps_requested = 0;
+    if (_running_until)
+    {
+        _endRunUntil();
+    }
+    _status_bar->showMessage("Step cancelled", 5000);
 }
 
 void DesignArea::continueSimulation()
 {
-    _timer->start();
+    _runner->resume();
+    _resumeUpdates();
 }
 
 void DesignArea::resetSimulation()
 {
-    _circuit_model.reset();
-    _ticks_label->setText("Ticks: 0");
-    emit resetResource();
+    _runner->reset();
+    _resumeUpdates();
+    _runner->update_snapshot();
+    _setTicksLabel(_runner->snapshot());
+    update();
+    emit resetResource(_runner->snapshot());
     if (_color_wires)
     {
-        emit resetWireResource();
+        emit resetWireResource(_runner->snapshot());
     }
 }
 
@@ -780,295 +1516,219 @@ QString DesignArea::filepath() const
 
 bool DesignArea::writeToFile(bool new_file)
 {
-    std::ofstream file;
-
     if (_filepath.isEmpty() || new_file)
     {
-        QString filepath =
-          QFileDialog::getSaveFileName(this,
-                                       "Save File",
-                                       "../LogicSim/saves/untitled.lsc",
-                                       "LogicSim Circuit files (*.lsc)");
+        QString filepath = QFileDialog::getSaveFileName(
+          this,
+          "Save File",
+          "../LogicSim/saves/untitled.lsc",
+          "LogicSim Circuit files (*.lsc);;LogicSim Binary Circuit files "
+          "(*.lsb)");
         if (filepath.isEmpty())
         {
             throw std::invalid_argument("");
         }
         _filepath = filepath;
-        file.open(_filepath.toStdString());
     }
-    else
-    {
-        file.open(_filepath.toStdString());
-    }
-
-    file << std::to_string(_freq) << "\n";
-
-    emit writeComponent(
-      file,
-      std::pow(INV_BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL),
-      _transformation.tx_inv,
-      _transformation.ty_inv);
-
-    file.close();
 
-    return !file.fail();
-}
+    // binary files are converted from the text representation
+    bool               binary = _filepath.endsWith(".lsb");
+    std::ofstream      text_file;
+    std::ostringstream text;
+    std::ostream      &file = binary ? static_cast<std::ostream &>(text)
+                                     : static_cast<std::ostream &>(text_file);
 
-void DesignArea::readFromFile(QString filepath)
-{
-    // TODO: defensive programming for changing file values
-    std::ifstream file(filepath.toStdString());
-
-    if (file.fail())
+    if (!binary)
     {
-        throw std::invalid_argument("File not found");
+        text_file.open(_filepath.toStdString());
     }
 
-    std::string line;
-
-    getline(file, line);
+    file << std::to_string(_freq) << ';' << std::to_string(_seed) << "\n";
 
-    if (!utils::is_positive_int(line))
+    // written in circuit order, whether they have a label or not
+    std::unordered_map<model::component::Component *, ComponentLabel *> labels;
+    for (const auto &label : _components)
     {
-        throw std::invalid_argument("Invalid file format: invalid frequency");
+        labels[label->component_model()] = label;
     }
-
-    _freq = std::stoi(line);
-
-    std::unordered_map<std::string, ComponentLabel *> components;
-    std::vector<std::pair<std::string, std::string>>  component_inputs;
-
-    logicsim::utils::StringSplitter splitter;
-
-    for (size_t i = 1; getline(file, line); ++i)
+    std::unordered_map<model::component::Component *, size_t> records;
+    for (size_t i = 0; i < _records.size(); ++i)
     {
-        splitter.reset(line, ';');
-
-        std::string id_str = splitter.next();
-        if (id_str.empty())
+        if (_records[i].label == nullptr)
         {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " empty");
-        }
-
-        std::string ctype;
-        if (!splitter.has_next() || (ctype = splitter.next()).empty())
-        {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) +
-                                        " missing component type");
+            records[_records[i].model] = i;
         }
-
-        std::string params;
-        if (!splitter.has_next())
+    }
+    for (const auto &component : _circuit_model.components())
+    {
+        auto label = labels.find(component);
+        if (label != labels.end())
         {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) +
-                                        " missing parameters");
+            label->second->writeComponent(file);
+            continue;
         }
-        params = splitter.next();
 
-        int res_idx;
+        const ComponentRecord &record = _records[records.at(component)];
+        ComponentLabel::writeRecord(file,
+                                    *component,
+                                    component->param_string(),
+                                    record.geometry.x(),
+                                    record.geometry.y());
+    }
 
-        if (utils::is_positive_int(params))
+    if (binary)
+    {
+        try
         {
-            res_idx = std::stoi(params);
+            model::file::write_binary(_filepath.toStdString(),
+                                      model::file::parse(text.str()));
         }
-        else
+        catch (const std::invalid_argument &)
         {
-            res_idx = 0;
+            return false;
         }
+        return true;
+    }
 
-        ComponentLabel *component =
-          new ComponentLabel(ctype_to_comp_type.at(ctype),
-                             res_idx,
-                             getScale(),
-                             _undo_stack,
-                             this);
-        _connectComponent(component, true);
-        components[id_str] = component;
+    text_file.close();
 
-        component->setParams(QString::fromStdString(params));
+    return !text_file.fail();
+}
 
-        if (!splitter.has_next())
-        {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) +
-                                        " missing coordinates");
-        }
+void DesignArea::readFromFile(QString filepath)
+{
+    model::file::CircuitFile circuit_file =
+      model::file::read_any(filepath.toStdString());
 
-        logicsim::utils::StringSplitter splitter2(splitter.next(), ',');
+    _freq = circuit_file.frequency;
+    _setSeed(circuit_file.seed);
 
-        int x, y;
-        try
-        {
-            x = std::stoi(splitter2.next());
-        }
-        catch (const std::invalid_argument &)
+    // repainted once, instead of per component and wire
+    update();
+
+    // components are kept as records; labels and wires are only created for
+    // those in the live area
+    size_t first_record      = _records.size();
+    size_t first_wire_record = _wire_records.size();
+    std::vector<ComponentRecord>               records;
+    std::vector<model::component::Component *> component_models;
+    records.reserve(circuit_file.components.size());
+    component_models.reserve(circuit_file.components.size());
+
+    auto delete_models = [&component_models]()
+    {
+        for (const auto &component_model : component_models)
         {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " bad coordinate");
+            delete component_model;
         }
+    };
 
-        if (!splitter2.has_next())
+    for (const auto &record : circuit_file.components)
+    {
+        auto comp_type_it = ctype_to_comp_type.find(std::string(record.ctype));
+        if (comp_type_it == ctype_to_comp_type.end())
         {
-            _deleteComponents(components);
+            delete_models();
             throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) +
-                                        " missing coordinate 2");
+                                        std::to_string(record.line) +
+                                        " unsupported component type");
         }
+        COMPONENT comp_type = comp_type_it->second;
 
-        try
+        int res_idx;
+
+        // only constants and switches pick their resource by parameter
+        if ((comp_type == CONSTANT || comp_type == SWITCH) &&
+            utils::is_positive_int(record.params))
         {
-            y = std::stoi(splitter2.next());
+            res_idx = std::stoi(std::string(record.params));
         }
-        catch (const std::invalid_argument &)
+        else
         {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " bad coordinate");
+            res_idx = 0;
         }
 
-        component->move(x, y);
-        component->show();
+        model::component::Component *component_model =
+          model::ctype_map.at(comp_type_to_ctype.at(comp_type))();
+        component_models.push_back(component_model);
 
-        if (splitter2.has_next())
+        try
         {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " too many fields");
+            component_model->set_params(model::file::record_params(record));
         }
-
-        if (!splitter.has_next())
+        catch (const std::logic_error &)
         {
-            _deleteComponents(components);
+            delete_models();
             throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " missing inputs");
+                                        std::to_string(record.line) +
+                                        " bad parameters");
         }
 
-        component_inputs.emplace_back(id_str, splitter.next());
-
-        if (splitter.has_next())
-        {
-            _deleteComponents(components);
-            throw std::invalid_argument("Invalid file format: line " +
-                                        std::to_string(i) + " too many fields");
-        }
+        records.push_back(
+          { comp_type,
+            res_idx,
+            QRect(QPoint(record.x, record.y),
+                  resources::getComponentSize(comp_type, res_idx)),
+            0,
+            component_model });
     }
 
-    file.close();
-
-    logicsim::utils::StringSplitter splitter2;
-
-    for (const auto &input : component_inputs)
+    std::vector<model::file::ResolvedInput> resolved_inputs;
+    try
     {
-        if (input.second.empty())
-        {
-            if (components[input.first]->component_model()->n_inputs() > 0)
-            {
-                _deleteComponents(components);
-                throw std::invalid_argument(
-                  "Invalid file format: missing inputs for component " +
-                  input.first);
-            }
-            continue;
-        }
-
-        splitter.reset(input.second, ',');
+        resolved_inputs =
+          model::file::resolve_inputs(circuit_file, component_models);
+    }
+    catch (const std::invalid_argument &)
+    {
+        delete_models();
+        throw;
+    }
 
-        size_t i;
-        for (i = 0; splitter.has_next(); ++i)
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const model::file::ComponentRecord &record =
+          circuit_file.components[i];
+        for (unsigned int j = 0; j < record.n_inputs; ++j)
         {
-            if (i >= components[input.first]->component_model()->n_inputs())
-            {
-                _deleteComponents(components);
-                throw std::invalid_argument(
-                  "Invalid file format: too many inputs for component " +
-                  input.first);
-            }
-            std::string input_str = splitter.next();
-            if (input_str == "NULL")
+            const model::file::ResolvedInput &input =
+              resolved_inputs[record.inputs_begin + j];
+            if (input.null)
             {
                 continue;
             }
-            splitter2.reset(input_str, ':');
-            std::string input_id_str = splitter2.next();
-            if (input_id_str.empty() ||
-                components.find(input_id_str) == components.end() ||
-                !splitter2.has_next())
-            {
-                _deleteComponents(components);
-                throw std::invalid_argument(
-                  "Invalid file format: invalid input for component " +
-                  input.first);
-            }
-            unsigned int output_idx;
-            try
-            {
-                output_idx = std::stoi(splitter2.next());
-                if (output_idx >=
-                    components[input_id_str]->component_model()->n_outputs())
-                {
-                    throw std::invalid_argument("");
-                }
-            }
-            catch (const std::invalid_argument &e)
-            {
-                _deleteComponents(components);
-                throw std::invalid_argument(
-                  "Invalid file format: invalid output index for component " +
-                  input.first);
-            }
-            if (splitter2.has_next())
-            {
-                _deleteComponents(components);
-                throw std::invalid_argument(
-                  "Invalid file format: too many fields for input of " +
-                  input.first);
-            }
 
-            Wire *wire = new Wire(getScale(), this);
-            _connectWire(wire);
-            wire->setComponent1(components[input.first], true, i);
-            wire->setComponent2(components[input_id_str], false, output_idx);
-            wire->saveInComponents();
-            wire->reposition();
-
-            model::component::NInputComponent *n_input_component =
-              static_cast<model::component::NInputComponent *>(
-                components[input.first]->component_model());
-            n_input_component->set_input(
-              i,
-              *(components[input_id_str]->component_model()),
-              output_idx);
+            static_cast<model::component::NInputComponent *>(
+              component_models[i])
+              ->set_input(j, *component_models[input.component_idx], input.out);
+
+            size_t wire_record_idx = _wire_records.size();
+            _wire_records.push_back({ first_record + input.component_idx,
+                                      first_record + i,
+                                      static_cast<int>(input.out),
+                                      static_cast<int>(j) });
+            records[i].wires.push_back(wire_record_idx);
+            records[input.component_idx].wires.push_back(wire_record_idx);
         }
+    }
 
-        if (i < components[input.first]->component_model()->n_inputs())
-        {
-            _deleteComponents(components);
-            throw std::invalid_argument(
-              "Invalid file format: missing inputs for component " +
-              input.first);
-        }
+    _circuit_model.reserve(_circuit_model.size() + records.size());
+    for (auto &record : records)
+    {
+        _circuit_model.add_component(*record.model);
+        record.stacking_order = ++_stacking_order;
+        _record_index.insert(_records.size(), record.geometry);
+        _records.push_back(std::move(record));
+    }
+    for (size_t i = first_wire_record; i < _wire_records.size(); ++i)
+    {
+        _wire_records[i].bounds = _wireRecordBounds(_wire_records[i]);
+        _wire_record_index.insert(i, _wire_records[i].bounds);
     }
 
     setMode(_selected_tool);
     _filepath = filepath;
-}
-
-void DesignArea::_deleteComponents(
-  std::unordered_map<std::string, ComponentLabel *> components)
-{
-    for (const auto &pair : components)
-    {
-        _circuit_model.remove_component(*(pair.second->component_model()));
-        delete pair.second;
-    }
+    _updateLiveArea();
 }
 
 void DesignArea::undoAction()
@@ -1172,18 +1832,22 @@ void DesignArea::deleteAction()
 void DesignArea::setColorWires(bool enabled)
 {
     _color_wires = enabled;
+    update();
     if (!_color_wires)
     {
         emit disableColorWires();
         return;
     }
 
-    emit resetWireResource();
+    if (_runner != nullptr)
+    {
+        emit resetWireResource(_runner->snapshot());
+    }
 }
 
 void DesignArea::zoomIn(int origin_x, int origin_y)
 {
-    if (_zoom_level < 15)
+    if (_zoom_level < MAX_ZOOM_LEVEL)
     {
         _zoom(origin_x, origin_y, _zoom_level + 1);
     }
@@ -1191,7 +1855,7 @@ void DesignArea::zoomIn(int origin_x, int origin_y)
 
 void DesignArea::zoomOut(int origin_x, int origin_y)
 {
-    if (_zoom_level > 2)
+    if (_zoom_level > MIN_ZOOM_LEVEL)
     {
         _zoom(origin_x, origin_y, _zoom_level - 1);
     }
@@ -1204,29 +1868,19 @@ void DesignArea::resetZoom()
 
 void DesignArea::_zoom(int origin_x, int origin_y, int new_zoom_level)
 {
-    double size_scale_factor =
-      std::pow(BASE_SCALE_FACTOR, new_zoom_level - BASE_ZOOM_LEVEL);
     double scale_factor =
       std::pow(BASE_SCALE_FACTOR, new_zoom_level - _zoom_level);
-    double prev_inv_scale_factor =
-      std::pow(INV_BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL);
-
-    _transformation.tx =
-      scale_factor * _transformation.tx - scale_factor * origin_x + origin_x;
-    _transformation.ty =
-      scale_factor * _transformation.ty - scale_factor * origin_y + origin_y;
 
-    _transformation.tx_inv +=
-      prev_inv_scale_factor * (origin_x - origin_x / scale_factor);
-    _transformation.ty_inv +=
-      prev_inv_scale_factor * (origin_y - origin_y / scale_factor);
-
-    emit transformScale(size_scale_factor,
-                        scale_factor,
-                        -scale_factor * origin_x + origin_x,
-                        -scale_factor * origin_y + origin_y);
+    double tx = scale_factor * _view.dx() - scale_factor * origin_x + origin_x;
+    double ty = scale_factor * _view.dy() - scale_factor * origin_y + origin_y;
 
     _zoom_level = new_zoom_level;
+    _setView(tx, ty);
+}
+
+bool DesignArea::_lowDetail() const
+{
+    return _zoom_level < LOW_DETAIL_ZOOM_LEVEL;
 }
 
 double DesignArea::getScale()
@@ -1246,71 +1900,320 @@ bool DesignArea::isDrawingWire()
 
 void DesignArea::nextComponent()
 {
-    if (_components.empty())
+    // components are visited in circuit order, whether they have a label or
+    // not
+    size_t n_components = _circuit_model.components().size();
+    if (n_components == 0)
     {
         return;
     }
-    _component_idx = (_component_idx + 1) % _components.size();
+    _component_idx = (_component_idx + 1) % n_components;
     _moveToComponent();
 }
 
 void DesignArea::previousComponent()
 {
-    if (_components.empty())
+    size_t n_components = _circuit_model.components().size();
+    if (n_components == 0)
     {
         return;
     }
     _component_idx =
-      _component_idx - 1 < 0 ? _components.size() - 1 : _component_idx - 1;
+      _component_idx - 1 < 0 ? n_components - 1 : _component_idx - 1;
     _moveToComponent();
 }
 
 void DesignArea::_moveToComponent()
 {
-    // native component coordinates
-    int native_x, native_y;
-    std::tie(native_x, native_y) =
-      _toNativeCoordinates(_components[_component_idx]->x(),
-                           _components[_component_idx]->y());
+    // index may be past the end after components were removed
+    const std::vector<model::component::Component *> &components =
+      _circuit_model.components();
+    _component_idx = _component_idx % static_cast<int>(components.size());
+    model::component::Component *component = components[_component_idx];
+
+    QPoint pos;
+    auto   label =
+      std::find_if(_components.begin(),
+                   _components.end(),
+                   [component](const ComponentLabel *candidate)
+                   { return candidate->component_model() == component; });
+    if (label != _components.end())
+    {
+        pos = (*label)->pos();
+    }
+    else
+    {
+        pos = std::find_if(_records.begin(),
+                           _records.end(),
+                           [component](const ComponentRecord &record)
+                           { return record.model == component; })
+                ->geometry.topLeft();
+    }
 
-    // new view position of component
-    int new_view_x = width() / 3;
-    int new_view_y = height() / 3;
+    // component is moved to a third of the view
+    double scale = getScale();
+    _setView(width() / 3 - scale * pos.x(), height() / 3 - scale * pos.y());
+}
 
-    // amount to move from current position to get to new position (offset)
-    int offset_x = new_view_x - _components[_component_idx]->x();
-    int offset_y = new_view_y - _components[_component_idx]->y();
+void DesignArea::_setView(double tx, double ty)
+{
+    double scale = getScale();
+    _view        = QTransform(scale, 0, 0, scale, tx, ty);
+    _inv_view    = _view.inverted();
+    // everything moves, so the whole area is repainted
+    update();
+    _updateLiveArea();
+}
 
-    double scale_factor =
-      std::pow(BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL);
-    double inv_scale_factor = 1 / scale_factor;
+void DesignArea::_updateLiveArea()
+{
+    int   margin         = LIVE_AREA_MARGIN;
+    QRect prev_live_area = _live_area;
+    _live_area =
+      _toNativeRect(rect().adjusted(-margin, -margin, margin, margin));
+
+    // records that entered the live area get their labels and wires
+    std::vector<size_t> entered;
+    _wire_record_index.query(_live_area, entered);
+    for (const auto &wire_record_idx : entered)
+    {
+        if (_wire_records[wire_record_idx].bounds.intersects(_live_area))
+        {
+            _createRecordWire(wire_record_idx);
+        }
+    }
+    entered.clear();
+    _record_index.query(_live_area, entered);
+    for (const auto &record_idx : entered)
+    {
+        if (_records[record_idx].geometry.intersects(_live_area))
+        {
+            _createRecordLabel(record_idx);
+        }
+    }
 
-    // since view moves to entirely different position, overwrite these with new
-    // position data
-    _transformation.tx = new_view_x - scale_factor * native_x;
-    _transformation.ty = new_view_y - scale_factor * native_y;
+    // and those that left it lose them
+    std::vector<size_t> unpinned_records;
+    for (const auto &record_idx : _unpinned_records)
+    {
+        if (_records[record_idx].pinned)
+        {
+            continue;
+        }
+        if (_recordInLiveArea(record_idx))
+        {
+            unpinned_records.push_back(record_idx);
+        }
+        else
+        {
+            _destroyRecordLabel(record_idx);
+        }
+    }
+    _unpinned_records.swap(unpinned_records);
+
+    if (_runner == nullptr)
+    {
+        return;
+    }
 
-    _transformation.tx_inv = native_x - inv_scale_factor * new_view_x;
-    _transformation.ty_inv = native_y - inv_scale_factor * new_view_y;
+    // items already in the previous live area are up to date
+    const model::sim::Snapshot &snapshot = _runner->snapshot();
+    for (const auto &component : _componentsNear(_live_area))
+    {
+        if (!component->geometry().intersects(prev_live_area))
+        {
+            component->evaluate(snapshot);
+        }
+    }
 
-    emit transformPosition(offset_x, offset_y);
+    if (!_color_wires)
+    {
+        return;
+    }
+    for (const auto &wire : _wiresNear(_live_area))
+    {
+        if (!wire->bounds().intersects(prev_live_area))
+        {
+            wire->evaluate(snapshot);
+        }
+    }
+}
+
+QRect DesignArea::_wireRecordBounds(const WireRecord &wire_record) const
+{
+    // same positions and extent as a wire between the labels would have
+    auto io_pos = [this](size_t record_idx, bool is_input, int idx)
+    {
+        const ComponentRecord &record = _records[record_idx];
+        const std::pair<double, double> &rel_pos =
+          resources::getComponentIOPositionVector(record.comp_type,
+                                                  is_input)[idx];
+        return record.geometry.topLeft() +
+               QPoint(static_cast<int>(rel_pos.first * record.geometry.width()),
+                      static_cast<int>(rel_pos.second *
+                                       record.geometry.height()));
+    };
+    QPoint source = io_pos(wire_record.source, false, wire_record.out);
+    QPoint dest   = io_pos(wire_record.dest, true, wire_record.in);
+    return QRect(QPoint(std::min(source.x(), dest.x()),
+                        std::min(source.y(), dest.y())),
+                 QPoint(std::max(source.x(), dest.x()),
+                        std::max(source.y(), dest.y())))
+      .adjusted(0, 0, resources::WIRE_THICKNESS, resources::WIRE_THICKNESS);
 }
 
-std::pair<int, int> DesignArea::_toNativeCoordinates(int x, int y)
+ComponentLabel *DesignArea::_createRecordLabel(size_t record_idx)
 {
-    double inv_scale_factor =
-      std::pow(INV_BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL);
+    ComponentRecord &record = _records[record_idx];
+    if (record.label != nullptr)
+    {
+        return record.label;
+    }
+
+    ComponentLabel *label = new ComponentLabel(record.comp_type,
+                                               record.res_idx,
+                                               record.model,
+                                               _view,
+                                               _undo_stack,
+                                               this);
+    record.label          = label;
+    _label_records[label] = record_idx;
+    _record_index.remove(record_idx);
+    _unpinned_records.push_back(record_idx);
+
+    label->move(record.geometry.x(), record.geometry.y());
+    // keeps its place among the components drawn on top of each other
+    label->setStackingOrder(record.stacking_order);
+    _connectLabel(label, true);
+    // while simulating, parameters are saved as the base ones; only pinned
+    // labels post input events, so the model still has its parameters
+    label->changeMode(_selected_tool);
+    if (_runner != nullptr)
+    {
+        label->setSnapshotSlot(_runner->slot(*record.model));
+        _simulated_labels[record.simulated_idx] = label;
+        label->evaluate(_runner->snapshot());
+    }
+    label->show();
 
-    return { std::round(inv_scale_factor * x + _transformation.tx_inv),
-             std::round(inv_scale_factor * y + _transformation.ty_inv) };
+    return label;
 }
 
-std::pair<int, int> DesignArea::_toViewCoordinates(int x, int y)
+void DesignArea::_createRecordWire(size_t wire_record_idx)
 {
-    double scale_factor =
-      std::pow(BASE_SCALE_FACTOR, _zoom_level - BASE_ZOOM_LEVEL);
-    return { std::round(scale_factor * x + _transformation.tx),
-             std::round(scale_factor * y + _transformation.ty) };
+    if (_wire_records[wire_record_idx].wire != nullptr)
+    {
+        return;
+    }
+    ComponentLabel *source =
+      _createRecordLabel(_wire_records[wire_record_idx].source);
+    ComponentLabel *dest =
+      _createRecordLabel(_wire_records[wire_record_idx].dest);
+    WireRecord &wire_record = _wire_records[wire_record_idx];
+
+    // component models are already connected
+    Wire *wire = new Wire(_view, this);
+    wire->setComponent1(dest, true, wire_record.in);
+    wire->setComponent2(source, false, wire_record.out);
+    wire->keepInComponents();
+    wire->reposition();
+    wire->changeMode(_selected_tool);
+    _connectWire(wire);
+    wire_record.wire = wire;
+    _wire_record_index.remove(wire_record_idx);
+
+    if (_runner != nullptr && _color_wires)
+    {
+        wire->evaluate(_runner->snapshot());
+    }
+}
+
+void DesignArea::_destroyRecordLabel(size_t record_idx)
+{
+    ComponentRecord &record = _records[record_idx];
+    ComponentLabel  *label  = record.label;
+
+    for (const auto &wire_record_idx : record.wires)
+    {
+        WireRecord &wire_record = _wire_records[wire_record_idx];
+        if (wire_record.wire == nullptr)
+        {
+            continue;
+        }
+        _disconnectWire(wire_record.wire);
+        wire_record.wire->dropFromComponents();
+        delete wire_record.wire;
+        wire_record.wire = nullptr;
+        _wire_record_index.insert(wire_record_idx, wire_record.bounds);
+    }
+
+    _disconnectLabel(label);
+    _label_records.erase(label);
+    if (_runner != nullptr)
+    {
+        _simulated_labels[record.simulated_idx] = nullptr;
+    }
+    record.model = label->releaseModel();
+    delete label;
+    record.label = nullptr;
+    _record_index.insert(record_idx, record.geometry);
+}
+
+bool DesignArea::_recordInLiveArea(size_t record_idx) const
+{
+    const ComponentRecord &record = _records[record_idx];
+    if (record.label->geometry().intersects(_live_area))
+    {
+        return true;
+    }
+    // wires crossing the live area keep the labels at their ends
+    for (const auto &wire_record_idx : record.wires)
+    {
+        const Wire *wire = _wire_records[wire_record_idx].wire;
+        if (wire != nullptr && wire->bounds().intersects(_live_area))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DesignArea::_pin(ComponentLabel *label)
+{
+    auto record_it = _label_records.find(label);
+    if (record_it == _label_records.end() || _records[record_it->second].wired)
+    {
+        return;
+    }
+    size_t record_idx           = record_it->second;
+    _records[record_idx].pinned = true;
+    _records[record_idx].wired  = true;
+
+    // components at the other end of its wires are kept too, and so are the
+    // wires
+    for (const auto &wire_record_idx : _records[record_idx].wires)
+    {
+        _createRecordWire(wire_record_idx);
+        const WireRecord &wire_record = _wire_records[wire_record_idx];
+        _records[wire_record.source].pinned = true;
+        _records[wire_record.dest].pinned   = true;
+    }
+}
+
+std::pair<int, int> DesignArea::_toNativeCoordinates(int x, int y) const
+{
+    QPoint native = _inv_view.map(QPointF(x, y)).toPoint();
+    return { native.x(), native.y() };
+}
+
+QRect DesignArea::_toNativeRect(const QRect &rect) const
+{
+    return _inv_view.mapRect(QRectF(rect))
+      .toAlignedRect()
+      .adjusted(-NATIVE_RECT_LEEWAY,
+                -NATIVE_RECT_LEEWAY,
+                NATIVE_RECT_LEEWAY,
+                NATIVE_RECT_LEEWAY);
 }
 
 } // namespace gui
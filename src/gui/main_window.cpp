@@ -79,6 +79,14 @@ MainWindow::MainWindow(QWidget *parent)
                 // already running so don't re-apply
                 setSimulationMenu(running, true);
             });
+    connect(_ui->tabHandler,
+            &TabHandler::simulationPaused,
+            this,
+            [this]()
+            {
+                _sim_paused = true;
+                _setSimulationMenu(true);
+            });
     connect(_ui->tabHandler,
             &TabHandler::undoActionPerformed,
             this,
@@ -322,6 +330,16 @@ MainWindow::MainWindow(QWidget *parent)
             _ui->tabHandler,
             &TabHandler::stepSimulation);
 
+    connect(_ui->actionRun_Ticks,
+            &QAction::triggered,
+            this,
+            &MainWindow::runTicks);
+
+    connect(_ui->actionCancel_Step,
+            &QAction::triggered,
+            _ui->tabHandler,
+            &TabHandler::cancelSteps);
+
     connect(_ui->actionContinue,
             &QAction::triggered,
             _ui->tabHandler,
@@ -450,6 +468,8 @@ void MainWindow::_setSimulationMenu(bool enabled)
 
     _ui->actionStep->setEnabled(enabled && _sim_paused);
     _step_sim_button->setEnabled(enabled && _sim_paused);
+    _ui->actionRun_Ticks->setEnabled(enabled && _sim_paused);
+    _ui->actionCancel_Step->setEnabled(enabled && _sim_paused);
     _ui->actionContinue->setEnabled(enabled && _sim_paused);
     _ui->actionPause->setEnabled(enabled && !_sim_paused);
     _pause_sim_button->setEnabled(enabled);
@@ -470,6 +490,8 @@ void MainWindow::enableContinue()
     _ui->actionContinue->setEnabled(true);
     _ui->actionStep->setEnabled(true);
     _step_sim_button->setEnabled(true);
+    _ui->actionRun_Ticks->setEnabled(true);
+    _ui->actionCancel_Step->setEnabled(true);
     _ui->actionPause->setEnabled(false);
     _sim_paused = true;
 }
@@ -479,10 +501,45 @@ void MainWindow::enablePause()
     _ui->actionPause->setEnabled(true);
     _ui->actionStep->setEnabled(false);
     _step_sim_button->setEnabled(false);
+    _ui->actionRun_Ticks->setEnabled(false);
+    _ui->actionCancel_Step->setEnabled(false);
     _ui->actionContinue->setEnabled(false);
     _sim_paused = false;
 }
 
+void MainWindow::runTicks()
+{
+    Properties *run_ticks_popup = new Properties("Run Ticks", this);
+
+    run_ticks_popup->addValueEntry(
+      "Ticks",
+      QString::number(_ui->tabHandler->currentDesignArea()->frequency()),
+      [](QLineEdit *entry)
+      {
+          bool          ok;
+          std::uint64_t val = entry->text().toULongLong(&ok);
+          if (!ok || val == 0)
+          {
+              return QString();
+          }
+          return QString::number(val);
+      });
+
+    connect(run_ticks_popup,
+            &Properties::optionValue,
+            this,
+            [this](QString value, int)
+            {
+                _ui->tabHandler->currentDesignArea()->runTicks(
+                  value.toULongLong());
+            });
+
+    QSize popup_size = run_ticks_popup->sizeHint();
+    run_ticks_popup->move(x() + width() / 2 - popup_size.width() / 2,
+                          y() + height() / 2 - popup_size.height() / 2);
+    run_ticks_popup->show();
+}
+
 void MainWindow::simulationProperties()
 {
     Properties *sim_properties_popup =
@@ -495,24 +552,40 @@ void MainWindow::simulationProperties()
       QString::number(_ui->tabHandler->currentDesignArea()->frequency()),
       [](QLineEdit *entry)
       {
-          bool ok;
-          int  val = entry->text().toInt(&ok);
-          if (!ok || val <= 0)
+          bool         ok;
+          unsigned int val = entry->text().toUInt(&ok);
+          if (!ok || val == 0)
           {
               return QString();
           }
-          if (val > 1000)
-          {
-              return QString("1000");
-          }
-          return entry->text();
+          return QString::number(val);
       },
       "Hz");
+    sim_properties_popup->addExclusiveGroup(
+      "Speed",
+      {
+        { "Frequency", "0" },
+        { "Max speed", "1" }
+    },
+      _ui->tabHandler->currentDesignArea()->maxSpeed());
+    sim_properties_popup->addValueEntry(
+      "Seed",
+      QString::number(_ui->tabHandler->currentDesignArea()->seed()),
+      [](QLineEdit *entry)
+      {
+          bool          ok;
+          std::uint64_t val = entry->text().toULongLong(&ok);
+          if (!ok)
+          {
+              return QString();
+          }
+          return QString::number(val);
+      });
 
     connect(sim_properties_popup,
             &Properties::optionValue,
             this,
-            &MainWindow::setSimulationFrequency);
+            &MainWindow::setSimulationProperty);
 
     QSize popup_size = sim_properties_popup->sizeHint();
     sim_properties_popup->move(x() + width() / 2 - popup_size.width() / 2,
@@ -520,9 +593,22 @@ void MainWindow::simulationProperties()
     sim_properties_popup->show();
 }
 
-void MainWindow::setSimulationFrequency(QString freq)
+void MainWindow::setSimulationProperty(QString value, int group_idx)
 {
-    _ui->tabHandler->currentDesignArea()->setFrequency(freq.toInt());
+    switch (group_idx)
+    {
+    case 0:
+        _ui->tabHandler->currentDesignArea()->setFrequency(value.toUInt());
+        break;
+    case 1:
+        _ui->tabHandler->currentDesignArea()->setMaxSpeed(value == "1");
+        break;
+    case 2:
+        _ui->tabHandler->currentDesignArea()->setSeed(value.toULongLong());
+        break;
+    default:
+        break;
+    }
 }
 
 void MainWindow::setUndoActionState(bool undo_enabled, bool redo_enabled)
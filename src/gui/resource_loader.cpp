@@ -41,82 +41,65 @@ const std::pair<int, int> getComponentIORelativePos(ComponentLabel *component,
     }
 }
 
-QPixmap getComponentResource(COMPONENT comp_type, int res_idx, double scale)
+QSize getComponentSize(COMPONENT comp_type, int res_idx)
 {
-    QPixmap &res = resources::comp_images.at(comp_type)[res_idx];
-    return res.scaled(static_cast<int>(scale * res.width()),
-                      static_cast<int>(scale * res.height()));
+    return comp_images.at(comp_type)[res_idx].size();
 }
 
-QPixmap getBorder(int width, int height)
+QPixmap getComponentResource(COMPONENT comp_type, int res_idx, double scale)
 {
-    QPixmap pixmap(width, height);
-    pixmap.fill(Qt::transparent);
-
-    QPainter painter(&pixmap);
-    painter.setPen(Qt::black);
-    painter.drawRect(0, 0, width - 1, height - 1);
+    auto level = std::find_if(scaled_images.begin(),
+                              scaled_images.end(),
+                              [scale](const ScaledImages &cached)
+                              { return cached.scale == scale; });
+    if (level == scaled_images.end())
+    {
+        if (scaled_images.size() < SCALED_IMAGES_LEVELS)
+        {
+            level = scaled_images.insert(scaled_images.end(), ScaledImages());
+        }
+        else
+        {
+            level = std::min_element(
+              scaled_images.begin(),
+              scaled_images.end(),
+              [](const ScaledImages &a, const ScaledImages &b)
+              { return a.last_used < b.last_used; });
+            level->images.clear();
+        }
+        level->scale = scale;
+    }
+    level->last_used = ++scaled_images_uses;
 
-    return pixmap;
-}
+    std::vector<QPixmap> &images = level->images[comp_type];
+    if (images.empty())
+    {
+        images.resize(comp_images.at(comp_type).size());
+    }
 
-QPixmap getLine(LINE_TYPE line_type, int size)
-{
-    switch (line_type)
+    QPixmap &scaled = images[res_idx];
+    if (scaled.isNull())
     {
-    case HORIZONTAL:
-    default:
-        return hselline->scaled(size, LINE_THICKNESS);
-    case VERTICAL:
-        return vselline->scaled(LINE_THICKNESS, size);
+        QPixmap &res = comp_images.at(comp_type)[res_idx];
+        scaled       = res.scaled(static_cast<int>(scale * res.width()),
+                            static_cast<int>(scale * res.height()));
     }
+    return scaled;
 }
 
-QPixmap getWire(LINE_TYPE line_type, int size, double scale,
-                const model::State &wire_type)
+void clearComponentResourceCache()
 {
-    switch (line_type)
-    {
-    case HORIZONTAL:
-    default:
-    {
-        QPixmap *wire;
-        switch (wire_type)
-        {
-        case model::State::ZERO:
-        default:
-            wire = hwire;
-            break;
-        case model::State::ONE:
-            wire = hwire_on;
-            break;
-        case model::State::HiZ:
-            wire = hwire_z;
-            break;
-        }
+    scaled_images.clear();
+}
 
-        return wire->scaled(size, static_cast<int>(scale * WIRE_THICKNESS));
-    }
-    case VERTICAL:
-    {
-        QPixmap *wire;
-        switch (wire_type)
-        {
-        case model::State::ZERO:
-        default:
-            wire = vwire;
-            break;
-        case model::State::ONE:
-            wire = vwire_on;
-            break;
-        case model::State::HiZ:
-            wire = vwire_z;
-            break;
-        }
+QColor getWireColor(const model::State &wire_type)
+{
+    return wire_colors[wire_type];
+}
 
-        return wire->scaled(static_cast<int>(scale * WIRE_THICKNESS), size);
-    }
-    }
+QColor getLineColor()
+{
+    return line_color;
 }
 
 QPixmap getWireMarking(LINE_TYPE line_type, int size, double scale, bool dir_ul)
@@ -235,6 +218,11 @@ void load()
     hwire_z     = new QPixmap(IMG_PATH + "hwire_z.png");
     vwire_z     = new QPixmap(IMG_PATH + "vwire_z.png");
 
+    wire_colors[model::State::ZERO] = hwire->toImage().pixelColor(0, 0);
+    wire_colors[model::State::ONE]  = hwire_on->toImage().pixelColor(0, 0);
+    wire_colors[model::State::HiZ]  = hwire_z->toImage().pixelColor(0, 0);
+    line_color                      = hselline->toImage().pixelColor(0, 0);
+
     select_icon      = new QIcon(IMG_PATH + "select_icon.png");
     move_icon        = new QIcon(IMG_PATH + "move_icon.png");
     wire_icon        = new QIcon(IMG_PATH + "wire_icon.png");
@@ -280,6 +268,7 @@ void load()
 
 void deallocate()
 {
+    clearComponentResourceCache();
     delete hselline;
     delete vselline;
     delete hwire;
@@ -75,6 +75,10 @@ void TabHandler::addDesignArea()
             &DesignArea::newSelection,
             this,
             &TabHandler::performSelectionAction);
+    connect(new_area,
+            &DesignArea::simulationPaused,
+            this,
+            &TabHandler::simulationPaused);
 
     addTab(new_area, "Untitled*");
     setCurrentWidget(new_area);
@@ -228,7 +232,7 @@ void TabHandler::openFile()
       QFileDialog::getOpenFileName(this,
                                    "Open File",
                                    "../LogicSim/saves/",
-                                   "LogicSim Circuit files (*.lsc)");
+                                   "LogicSim Circuit files (*.lsc *.lsb)");
 
     if (filepath.isEmpty())
     {
@@ -472,6 +476,11 @@ void TabHandler::stepSimulation()
     currentDesignArea()->stepSimulation();
 }
 
+void TabHandler::cancelSteps()
+{
+    currentDesignArea()->cancelSteps();
+}
+
 void TabHandler::continueSimulation()
 {
     currentDesignArea()->continueSimulation();
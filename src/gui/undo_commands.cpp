@@ -11,10 +11,12 @@ InsertComponentCommand::InsertComponentCommand(DesignArea  *design_area,
   : _design_area(design_area)
   , _component(new ComponentLabel(
       _design_area->_insert_component, _design_area->_insert_resource_idx,
-      _design_area->getScale(), _design_area->_undo_stack, _design_area))
+      _design_area->_view, _design_area->_undo_stack, _design_area))
 {
-    _component->move(ev->x() - _component->width() / 2,
-                     ev->y() - _component->height() / 2);
+    int x, y;
+    std::tie(x, y) = _design_area->_toNativeCoordinates(ev->x(), ev->y());
+    _component->move(x - _component->width() / 2,
+                     y - _component->height() / 2);
 }
 
 InsertComponentCommand::InsertComponentCommand(DesignArea     *design_area,
@@ -87,9 +89,9 @@ void DeleteComponentsCommand::redo()
             }
         }
 
-        for (const auto &output : component->outputWires())
+        for (const auto &net : component->outputNets())
         {
-            for (const auto &wire : output)
+            for (const auto &wire : net.wires)
             {
                 _design_area->_disconnectWire(wire);
             }
@@ -113,9 +115,9 @@ void DeleteComponentsCommand::undo()
             }
         }
 
-        for (const auto &output : component->outputWires())
+        for (const auto &net : component->outputNets())
         {
-            for (const auto &wire : output)
+            for (const auto &wire : net.wires)
             {
                 _design_area->_connectWire(wire);
             }
@@ -190,45 +192,26 @@ MoveComponentsCommand::MoveComponentsCommand(
   std::vector<QPoint> init_positions, std::vector<QPoint> final_positions)
   : _design_area(design_area)
   , _moved_components(moved_components)
-  , _init_positions(std::vector<QPoint>(init_positions.size()))
-  , _final_positions(std::vector<QPoint>(final_positions.size()))
+  , _init_positions(init_positions)
+  , _final_positions(final_positions)
 {
-    // transform to native coordinates
-    std::pair<int, int> coords;
-    for (size_t i = 0; i < moved_components.size(); ++i)
-    {
-        // TODO: possibly keep position as double
-        coords = _design_area->_toNativeCoordinates(init_positions[i].x(),
-                                                    init_positions[i].y());
-        _init_positions[i].setX(coords.first);
-        _init_positions[i].setY(coords.second);
-
-        coords = _design_area->_toNativeCoordinates(final_positions[i].x(),
-                                                    final_positions[i].y());
-        _final_positions[i].setX(coords.first);
-        _final_positions[i].setY(coords.second);
-    }
 }
 
 void MoveComponentsCommand::redo()
 {
-    std::pair<int, int> coords;
     for (size_t i = 0; i < _moved_components.size(); ++i)
     {
-        coords = _design_area->_toViewCoordinates(_final_positions[i].x(),
-                                                  _final_positions[i].y());
-        _moved_components[i]->move(coords.first, coords.second);
+        _moved_components[i]->move(_final_positions[i].x(),
+                                   _final_positions[i].y());
     }
 }
 
 void MoveComponentsCommand::undo()
 {
-    std::pair<int, int> coords;
     for (size_t i = 0; i < _moved_components.size(); ++i)
     {
-        coords = _design_area->_toViewCoordinates(_init_positions[i].x(),
-                                                  _init_positions[i].y());
-        _moved_components[i]->move(coords.first, coords.second);
+        _moved_components[i]->move(_init_positions[i].x(),
+                                   _init_positions[i].y());
     }
 }
 
@@ -269,28 +252,42 @@ void ChangeComponentPropertyCommand::undo()
 
 // ChangeSimulationPropertiesCommand
 ChangeSimulationPropertiesCommand::ChangeSimulationPropertiesCommand(
-  DesignArea *design_area, int prev_freq, int freq)
+  DesignArea *design_area, unsigned int prev_freq, bool prev_max_speed,
+  std::uint64_t prev_seed, unsigned int freq, bool max_speed,
+  std::uint64_t seed)
   : _design_area(design_area)
   , _prev_freq(prev_freq)
   , _freq(freq)
+  , _prev_max_speed(prev_max_speed)
+  , _max_speed(max_speed)
+  , _prev_seed(prev_seed)
+  , _seed(seed)
 {
 }
 
 void ChangeSimulationPropertiesCommand::redo()
 {
-    _design_area->_freq = _freq;
-    if (_design_area->_timer != nullptr)
+    _design_area->_freq      = _freq;
+    _design_area->_max_speed = _max_speed;
+    _design_area->_setSeed(_seed);
+    if (_design_area->_runner != nullptr)
     {
-        _design_area->_timer->setInterval(1000 / _freq);
+        _design_area->_runner->set_frequency(
+          _design_area->_runnerFrequency());
+        _design_area->_resumeUpdates();
     }
 }
 
 void ChangeSimulationPropertiesCommand::undo()
 {
-    _design_area->_freq = _prev_freq;
-    if (_design_area->_timer != nullptr)
+    _design_area->_freq      = _prev_freq;
+    _design_area->_max_speed = _prev_max_speed;
+    _design_area->_setSeed(_prev_seed);
+    if (_design_area->_runner != nullptr)
     {
-        _design_area->_timer->setInterval(1000 / _prev_freq);
+        _design_area->_runner->set_frequency(
+          _design_area->_runnerFrequency());
+        _design_area->_resumeUpdates();
     }
 }
 }
@@ -5,69 +5,11 @@ namespace logicsim
 {
 namespace gui
 {
-Wire::Wire(double scale, QWidget *parent) : QWidget { parent }
+Wire::Wire(const QTransform &view, QWidget *parent)
+  : QObject { parent }
+  , _design_area(parent)
+  , _view(&view)
 {
-    _scale = SCALE_SCALING_FACTOR * scale;
-
-    _hwire1 = new QLabel(parent);
-    _vwire  = new QLabel(parent);
-    _hwire2 = new QLabel(parent);
-
-    _hwire1->show();
-    _vwire->show();
-    _hwire2->show();
-
-    _hwire1_on = new QLabel(parent);
-    _vwire_on  = new QLabel(parent);
-    _hwire2_on = new QLabel(parent);
-
-    _hwire1_on->hide();
-    _vwire_on->hide();
-    _hwire2_on->hide();
-
-    _hwire1_z = new QLabel(parent);
-    _vwire_z  = new QLabel(parent);
-    _hwire2_z = new QLabel(parent);
-
-    _hwire1_z->hide();
-    _vwire_z->hide();
-    _hwire2_z->hide();
-
-    _hwire1_up   = new QLabel(parent);
-    _hwire1_down = new QLabel(parent);
-    _vwire_left  = new QLabel(parent);
-    _vwire_right = new QLabel(parent);
-    _hwire2_up   = new QLabel(parent);
-    _hwire2_down = new QLabel(parent);
-
-    _hwire1_up->hide();
-    _hwire1_down->hide();
-    _vwire_left->hide();
-    _vwire_right->hide();
-    _hwire2_up->hide();
-    _hwire2_down->hide();
-}
-
-Wire::~Wire()
-{
-    delete _hwire1;
-    delete _vwire;
-    delete _hwire2;
-
-    delete _hwire1_on;
-    delete _vwire_on;
-    delete _hwire2_on;
-
-    delete _hwire1_z;
-    delete _vwire_z;
-    delete _hwire2_z;
-
-    delete _hwire1_up;
-    delete _hwire1_down;
-    delete _vwire_left;
-    delete _vwire_right;
-    delete _hwire2_up;
-    delete _hwire2_down;
 }
 
 bool Wire::setComponent1(ComponentLabel *component, int dx, int dy)
@@ -92,41 +34,10 @@ bool Wire::setComponent2(ComponentLabel *component, bool is_input, int io_idx)
 
 void Wire::repositionDest(int dest_x, int dest_y)
 {
-    // refresh potential loaded colored wires
-    _wire_on = false;
-
-    int src_x = _conns[0].x;
-    int src_y = _conns[0].y;
-
-    int hwire_size = std::abs(src_x - dest_x) / 2;
-    int vwire_size = std::abs(src_y - dest_y) +
-                     static_cast<int>(_scale * resources::WIRE_THICKNESS);
-
-    QPixmap hwire =
-      resources::getWire(resources::LINE_TYPE::HORIZONTAL, hwire_size, _scale);
-    QPixmap vwire =
-      resources::getWire(resources::LINE_TYPE::VERTICAL, vwire_size, _scale);
-
-    _hwire1->resize(hwire.width(), hwire.height());
-    _hwire2->resize(hwire.width(), hwire.height());
-    _vwire->resize(vwire.width(), vwire.height());
-
-    _hwire1->setPixmap(hwire);
-    _hwire2->setPixmap(hwire);
-    _vwire->setPixmap(vwire);
-
-    if (src_x > dest_x)
-    {
-        std::swap(src_x, dest_x);
-        std::swap(src_y, dest_y);
-    }
-
-    int min_y = std::min(src_y, dest_y);
-    int mid_x = src_x + hwire_size;
-
-    _hwire1->move(src_x, src_y);
-    _vwire->move(mid_x, min_y);
-    _hwire2->move(mid_x, dest_y);
+    _update();
+    _conns[1].x = dest_x;
+    _conns[1].y = dest_y;
+    _update();
 }
 
 bool Wire::saveInComponents()
@@ -151,41 +62,143 @@ bool Wire::saveInComponents()
     return true;
 }
 
+bool Wire::keepInComponents()
+{
+    if (!(_conns[0].is_input ^ _conns[1].is_input) ||
+        _conns[0].component == _conns[1].component)
+    {
+        return false;
+    }
+    if (!_conns[0].component->keepWire(this, _conns[0].is_input, _conns[0].idx))
+    {
+        return false;
+    }
+    if (!_conns[1].component->keepWire(this, _conns[1].is_input, _conns[1].idx))
+    {
+        _conns[0].component->dropWire(this, _conns[0].is_input, _conns[0].idx);
+        return false;
+    }
+
+    return true;
+}
+
 void Wire::reposition()
 {
     _updatePosition(0);
     _updatePosition(1);
     repositionDest(_conns[1].x, _conns[1].y);
-    if (_current_tool == TOOL::SIMULATE)
-    {
-        _wire_on = false;
-        _createColorWire();
-    }
 }
 
 void Wire::hide()
 {
-    _hwire1->hide();
-    _vwire->hide();
-    _hwire2->hide();
-
-    _hwire1_up->hide();
-    _hwire1_down->hide();
-    _vwire_left->hide();
-    _vwire_right->hide();
-    _hwire2_up->hide();
-    _hwire2_down->hide();
-
+    _update();
     _hidden = true;
 }
 
 void Wire::show()
 {
-    _hwire1->show();
-    _vwire->show();
-    _hwire2->show();
-
     _hidden = false;
+    _update();
+}
+
+bool Wire::isHidden() const
+{
+    return _hidden;
+}
+
+QRect Wire::bounds() const
+{
+    return QRect(QPoint(std::min(_conns[0].x, _conns[1].x),
+                        std::min(_conns[0].y, _conns[1].y)),
+                 QPoint(std::max(_conns[0].x, _conns[1].x),
+                        std::max(_conns[0].y, _conns[1].y)))
+      .adjusted(0, 0, resources::WIRE_THICKNESS, resources::WIRE_THICKNESS);
+}
+
+model::State Wire::state() const
+{
+    return _state;
+}
+
+void Wire::addSegments(std::vector<QRect> &rects) const
+{
+    QRect segments[3];
+    _viewSegments(segments);
+    rects.insert(rects.end(), std::begin(segments), std::end(segments));
+}
+
+QLine Wire::viewLine() const
+{
+    return QLine(_view->map(QPoint(_conns[0].x, _conns[0].y)),
+                 _view->map(QPoint(_conns[1].x, _conns[1].y)));
+}
+
+void Wire::paintMarkings(QPainter &painter) const
+{
+    if (!_marked || _hidden)
+    {
+        return;
+    }
+
+    QRect segments[3];
+    _viewSegments(segments);
+    const QRect &hwire1 = segments[0];
+    const QRect &vwire  = segments[1];
+    const QRect &hwire2 = segments[2];
+
+    double  scale = std::min(1.5 * _scale(), 2.5);
+    QPixmap hup   = resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
+                                            hwire1.width(),
+                                            scale);
+    QPixmap hdown = resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
+                                              hwire1.width(),
+                                              scale,
+                                              false);
+    QPixmap vleft = resources::getWireMarking(resources::LINE_TYPE::VERTICAL,
+                                              vwire.height(),
+                                              scale);
+    QPixmap vright = resources::getWireMarking(resources::LINE_TYPE::VERTICAL,
+                                               vwire.height(),
+                                               scale,
+                                               false);
+    QPixmap hup_ext = hup, hdown_ext = hdown;
+    int     move_size = 0;
+
+    bool dir = hwire1.y() < hwire2.y();
+    bool eq  = hwire1.y() == hwire2.y();
+
+    if (!eq)
+    {
+        int ext_size = hwire1.height() + _markingThickness();
+        hup_ext = resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
+                                            hwire1.width() + ext_size,
+                                            scale);
+        hdown_ext =
+          resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
+                                    hwire1.width() + ext_size,
+                                    scale,
+                                    false);
+        move_size = hup_ext.height();
+    }
+
+    const QPixmap &h1up = dir ? hup_ext : hup;
+    painter.drawPixmap(hwire1.x(), hwire1.y() - h1up.height(), h1up);
+
+    const QPixmap &h1down = !dir ? hdown_ext : hdown;
+    painter.drawPixmap(hwire1.x(), hwire1.y() + hwire1.height(), h1down);
+
+    painter.drawPixmap(vwire.x() - vleft.width(), vwire.y(), vleft);
+    painter.drawPixmap(vwire.x() + vwire.width(), vwire.y(), vright);
+
+    const QPixmap &h2up = !dir ? hup_ext : hup;
+    painter.drawPixmap(hwire2.x() - (!dir ? move_size : 0),
+                       hwire2.y() - h2up.height(),
+                       h2up);
+
+    const QPixmap &h2down = dir ? hdown_ext : hdown;
+    painter.drawPixmap(hwire2.x() - (dir ? move_size : 0),
+                       hwire2.y() + hwire2.height(),
+                       h2down);
 }
 
 std::pair<ComponentLabel *, int> Wire::outputComponentInfo() const
@@ -246,6 +259,12 @@ void Wire::removeFromComponents()
     _conns[1].component->removeWire(this, _conns[1].is_input, _conns[1].idx);
 }
 
+void Wire::dropFromComponents()
+{
+    _conns[0].component->dropWire(this, _conns[0].is_input, _conns[0].idx);
+    _conns[1].component->dropWire(this, _conns[1].is_input, _conns[1].idx);
+}
+
 bool Wire::_setComponent(int idx, ComponentLabel *component, int dx, int dy)
 {
     bool result = Wire::calculateWireTargetPos(component,
@@ -258,6 +277,7 @@ bool Wire::_setComponent(int idx, ComponentLabel *component, int dx, int dy)
     if (result)
     {
         _conns[idx].component = component;
+        _startDestAtSource(idx);
     }
 
     return result;
@@ -281,10 +301,20 @@ bool Wire::_setComponent(int idx, ComponentLabel *component, bool is_input,
       resources::getComponentIORelativePos(component, is_input, io_idx);
     _conns[idx].x += component->x();
     _conns[idx].y += component->y();
+    _startDestAtSource(idx);
 
     return true;
 }
 
+void Wire::_startDestAtSource(int idx)
+{
+    if (idx == 0 && _conns[1].component == nullptr)
+    {
+        _conns[1].x = _conns[0].x;
+        _conns[1].y = _conns[0].y;
+    }
+}
+
 void Wire::_updatePosition(int idx)
 {
     int rel_x, rel_y;
@@ -333,7 +363,7 @@ bool Wire::calculateWireTargetPos(ComponentLabel *component, int dx, int dy,
     return true;
 }
 
-void Wire::checkProximity(int x, int y)
+void Wire::checkProximity(int x, int y, double threshold)
 {
     int middle = (_conns[0].x + _conns[1].x) / 2;
     int distances[3];
@@ -395,7 +425,7 @@ void Wire::checkProximity(int x, int y)
 
     for (const auto &distance : distances)
     {
-        if (distance <= WIRE_REMOVE_DISTANCE_THRESHOLD)
+        if (distance <= threshold)
         {
             emit proximityConfirmed(this, distance);
             break;
@@ -410,241 +440,93 @@ void Wire::changeMode(TOOL tool)
         uncolor();
     }
 
-    switch (tool)
-    {
-    case WIRE_REMOVE:
-        _updateWireMarkings();
-        break;
-    default:
-        _updated_markings = false;
-        break;
-    }
-
     _current_tool = tool;
 }
 
 void Wire::markForDeletion()
 {
-    _hwire1_up->show();
-    _hwire1_down->show();
-    _vwire_left->show();
-    _vwire_right->show();
-    _hwire2_up->show();
-    _hwire2_down->show();
+    _marked = true;
+    _update();
 }
 
 void Wire::unmarkForDeletion()
 {
-    _hwire1_up->hide();
-    _hwire1_down->hide();
-    _vwire_left->hide();
-    _vwire_right->hide();
-    _hwire2_up->hide();
-    _hwire2_down->hide();
+    _marked = false;
+    _update();
 }
 
-void Wire::evaluate()
+void Wire::evaluate(const model::sim::Snapshot &snapshot)
 {
     if (_hidden)
     {
         return;
     }
-    _createColorWire();
 
     int conn_idx = _conns[0].is_input;
-    switch (_conns[conn_idx].component->getValue(_conns[conn_idx].idx))
-    {
-    case model::State::ZERO:
-        uncolor();
-        break;
-    case model::State::ONE:
-        _hwire1->hide();
-        _vwire->hide();
-        _hwire2->hide();
-
-        _hwire1_z->hide();
-        _vwire_z->hide();
-        _hwire2_z->hide();
-
-        _hwire1_on->show();
-        _vwire_on->show();
-        _hwire2_on->show();
-        break;
-    case model::State::HiZ:
-        _hwire1->hide();
-        _vwire->hide();
-        _hwire2->hide();
-
-        _hwire1_on->hide();
-        _vwire_on->hide();
-        _hwire2_on->hide();
-
-        _hwire1_z->show();
-        _vwire_z->show();
-        _hwire2_z->show();
-        break;
-    }
+    setState(
+      _conns[conn_idx].component->getValue(snapshot, _conns[conn_idx].idx));
 }
 
-void Wire::_createColorWire()
+void Wire::setState(model::State state)
 {
-    if (!_wire_on)
+    if (_hidden || state == _state)
     {
-        QPixmap hwire_on = resources::getWire(resources::LINE_TYPE::HORIZONTAL,
-                                              _hwire1->width(),
-                                              _scale,
-                                              model::State::ONE);
-
-        _hwire1_on->setPixmap(hwire_on);
-        _hwire1_on->resize(_hwire1->width(), _hwire1->height());
-        _hwire1_on->move(_hwire1->x(), _hwire1->y());
-
-        _vwire_on->setPixmap(resources::getWire(resources::LINE_TYPE::VERTICAL,
-                                                _vwire->height(),
-                                                _scale,
-                                                model::State::ONE));
-        _vwire_on->resize(_vwire->width(), _vwire->height());
-        _vwire_on->move(_vwire->x(), _vwire->y());
-
-        _hwire2_on->setPixmap(hwire_on);
-        _hwire2_on->resize(_hwire2->width(), _hwire2->height());
-        _hwire2_on->move(_hwire2->x(), _hwire2->y());
-
-        QPixmap hwire_z = resources::getWire(resources::LINE_TYPE::HORIZONTAL,
-                                             _hwire1->width(),
-                                             _scale,
-                                             model::State::HiZ);
-
-        _hwire1_z->setPixmap(hwire_z);
-        _hwire1_z->resize(_hwire1->width(), _hwire1->height());
-        _hwire1_z->move(_hwire1->x(), _hwire1->y());
-
-        _vwire_z->setPixmap(resources::getWire(resources::LINE_TYPE::VERTICAL,
-                                               _vwire->height(),
-                                               _scale,
-                                               model::State::HiZ));
-        _vwire_z->resize(_vwire->width(), _vwire->height());
-        _vwire_z->move(_vwire->x(), _vwire->y());
-
-        _hwire2_z->setPixmap(hwire_z);
-        _hwire2_z->resize(_hwire2->width(), _hwire2->height());
-        _hwire2_z->move(_hwire2->x(), _hwire2->y());
-
-        _wire_on = true;
+        return;
     }
+    _state = state;
+    _update();
 }
 
-void Wire::_updateWireMarkings()
+void Wire::uncolor()
 {
-    if (!_updated_markings)
+    if (_state != model::State::ZERO)
     {
-        double  scale = std::min(1.5 * _scale, 2.5);
-        QPixmap hup =
-          resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
-                                    _hwire1->width(),
-                                    scale);
-        QPixmap hdown =
-          resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
-                                    _hwire1->width(),
-                                    scale,
-                                    false);
-        QPixmap hleft =
-          resources::getWireMarking(resources::LINE_TYPE::VERTICAL,
-                                    _vwire->height(),
-                                    scale);
-        QPixmap hright =
-          resources::getWireMarking(resources::LINE_TYPE::VERTICAL,
-                                    _vwire->height(),
-                                    scale,
-                                    false);
-        QPixmap hup_ext = hup, hdown_ext = hdown;
-        int     ext_size  = 0;
-        int     move_size = 0;
-
-        bool dir = _hwire1->y() < _hwire2->y();
-        bool eq  = _hwire1->y() == _hwire2->y();
-
-        if (!eq)
-        {
-            ext_size =
-              _hwire1->height() +
-              static_cast<int>(scale * resources::WIRE_MARKING_THICKNESS);
-            hup_ext =
-              resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
-                                        _hwire1->width() + ext_size,
-                                        scale);
-            hdown_ext =
-              resources::getWireMarking(resources::LINE_TYPE::HORIZONTAL,
-                                        _hwire1->width() + ext_size,
-                                        scale,
-                                        false);
-            move_size = hup_ext.height();
-        }
-
-        QPixmap &h1up = dir ? hup_ext : hup;
-        _hwire1_up->setPixmap(h1up);
-        _hwire1_up->resize(h1up.width(), h1up.height());
-        _hwire1_up->move(_hwire1->x(), _hwire1->y() - h1up.height());
-
-        QPixmap &h1down = !dir ? hdown_ext : hdown;
-        _hwire1_down->setPixmap(h1down);
-        _hwire1_down->resize(h1down.width(), h1down.height());
-        _hwire1_down->move(_hwire1->x(), _hwire1->y() + _hwire1->height());
-
-        _vwire_left->setPixmap(hleft);
-        _vwire_left->resize(hleft.width(), hleft.height());
-        _vwire_left->move(_vwire->x() - hleft.width(), _vwire->y());
-
-        _vwire_right->setPixmap(hright);
-        _vwire_right->resize(hright.width(), hright.height());
-        _vwire_right->move(_vwire->x() + _vwire->width(), _vwire->y());
-
-        QPixmap &h2up = !dir ? hup_ext : hup;
-        _hwire2_up->setPixmap(h2up);
-        _hwire2_up->resize(h2up.width(), h2up.height());
-        _hwire2_up->move(_hwire2->x() - (!dir ? move_size : 0),
-                         _hwire2->y() - h2up.height());
-
-        QPixmap &h2down = dir ? hdown_ext : hdown;
-        _hwire2_down->setPixmap(h2down);
-        _hwire2_down->resize(h2down.width(), h2down.height());
-        _hwire2_down->move(_hwire2->x() - (dir ? move_size : 0),
-                           _hwire2->y() + _hwire2->height());
-
-        _updated_markings = true;
+        _state = model::State::ZERO;
+        _update();
     }
 }
 
-void Wire::uncolor()
+void Wire::_viewSegments(QRect segments[3]) const
 {
-    if (!_hidden)
+    QPoint src  = _view->map(QPoint(_conns[0].x, _conns[0].y));
+    QPoint dest = _view->map(QPoint(_conns[1].x, _conns[1].y));
+
+    int thickness  = static_cast<int>(_scale() * resources::WIRE_THICKNESS);
+    int hwire_size = std::abs(src.x() - dest.x()) / 2;
+    int vwire_size = std::abs(src.y() - dest.y()) + thickness;
+
+    if (src.x() > dest.x())
     {
-        _hwire1->show();
-        _vwire->show();
-        _hwire2->show();
+        std::swap(src, dest);
     }
 
-    _hwire1_on->hide();
-    _vwire_on->hide();
-    _hwire2_on->hide();
+    int min_y = std::min(src.y(), dest.y());
+    int mid_x = src.x() + hwire_size;
 
-    _hwire1_z->hide();
-    _vwire_z->hide();
-    _hwire2_z->hide();
+    segments[0] = QRect(src.x(), src.y(), hwire_size, thickness);
+    segments[1] = QRect(mid_x, min_y, thickness, vwire_size);
+    segments[2] = QRect(mid_x, dest.y(), hwire_size, thickness);
+}
+
+double Wire::_scale() const
+{
+    return SCALE_SCALING_FACTOR * _view->m11();
 }
 
-void Wire::scaleTransformationApplied(double size_scale)
+int Wire::_markingThickness() const
 {
-    _scale = SCALE_SCALING_FACTOR * size_scale;
-    reposition();
-    _updated_markings = false;
-    _updateWireMarkings();
+    return static_cast<int>(std::min(1.5 * _scale(), 2.5) *
+                            resources::WIRE_MARKING_THICKNESS);
 }
 
-void Wire::updateColorWire()
+void Wire::_update() const
 {
-    _wire_on = false;
-    evaluate();
+    QRect segments[3];
+    _viewSegments(segments);
+    // marking extends past the ends of the horizontal segments
+    int margin = segments[0].height() + 2 * _markingThickness();
+    _design_area->update((segments[0] | segments[1] | segments[2])
+                           .adjusted(-margin, -margin, margin, margin));
 }
 }
 }
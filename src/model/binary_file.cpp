@@ -0,0 +1,351 @@
+#include "model/binary_file.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+namespace
+{
+struct Header
+{
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t frequency;
+    std::uint32_t n_ctypes;
+    std::uint32_t n_components;
+    std::uint32_t n_inputs;
+    std::uint32_t strings_size;
+    std::uint32_t seed_low;
+    std::uint32_t seed_high;
+};
+
+static_assert(sizeof(Header) == 40, "Unexpected binary header padding");
+
+// version 1 headers have no seed
+constexpr size_t HEADER_V1_SIZE = 32;
+
+std::invalid_argument format_error(const std::string &message)
+{
+    return std::invalid_argument("Invalid file format: " + message);
+}
+
+// sequential reader of the sections of a mapped file
+class SectionReader
+{
+  public:
+    SectionReader(const char *data, size_t size) : _data(data), _size(size) {}
+
+    const std::uint32_t *next(size_t n)
+    {
+        if (n > (_size - _pos) / sizeof(std::uint32_t))
+        {
+            throw format_error("truncated file");
+        }
+        const std::uint32_t *section =
+          reinterpret_cast<const std::uint32_t *>(_data + _pos);
+        _pos += n * sizeof(std::uint32_t);
+        return section;
+    }
+
+    const char *rest(size_t n)
+    {
+        if (n > _size - _pos)
+        {
+            throw format_error("truncated file");
+        }
+        return _data + _pos;
+    }
+
+  protected:
+    const char *_data;
+    size_t      _size;
+    size_t      _pos = 0;
+};
+
+// checks that offsets[0..n] delimit strings within strings_size
+void check_offsets(const std::uint32_t *offsets, size_t n,
+                   std::uint32_t strings_size)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > strings_size)
+        {
+            throw format_error("bad string offsets");
+        }
+    }
+}
+
+template <typename T> void write_values(std::ofstream &file, const T &values)
+{
+    file.write(reinterpret_cast<const char *>(values.data()),
+               values.size() * sizeof(values[0]));
+}
+}
+
+bool is_binary(const std::string &filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    char          magic[4];
+
+    return file.read(magic, 4) &&
+           std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+}
+
+CircuitFile read_binary(const std::string &filepath)
+{
+    std::shared_ptr<const MappedFile> mapped =
+      std::make_shared<const MappedFile>(filepath);
+
+    if (mapped->size() < HEADER_V1_SIZE)
+    {
+        throw format_error("truncated file");
+    }
+
+    Header header {};
+    std::memcpy(&header, mapped->data(), HEADER_V1_SIZE);
+
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw format_error("not a binary circuit file");
+    }
+    if (header.version == 0 || header.version > BINARY_VERSION)
+    {
+        throw format_error("unsupported version " +
+                           std::to_string(header.version));
+    }
+    if (header.byte_order != BINARY_BYTE_ORDER)
+    {
+        throw format_error("unsupported byte order");
+    }
+
+    size_t header_size = header.version >= 2 ? sizeof(Header) : HEADER_V1_SIZE;
+    if (mapped->size() < header_size)
+    {
+        throw format_error("truncated file");
+    }
+    std::memcpy(&header, mapped->data(), header_size);
+
+    // counts are widened before any arithmetic, so that n + 1 cannot wrap,
+    // and every section is checked against the file size by the reader before
+    // anything is indexed or allocated
+    size_t n        = header.n_components;
+    size_t n_ctypes = header.n_ctypes;
+    size_t n_inputs = header.n_inputs;
+
+    SectionReader reader(mapped->data() + header_size,
+                         mapped->size() - header_size);
+
+    const std::uint32_t *ctype_offsets    = reader.next(n_ctypes + 1);
+    const std::uint32_t *ctypes           = reader.next(n);
+    const std::uint32_t *coordinates      = reader.next(2 * n);
+    const std::uint32_t *id_offsets       = reader.next(n + 1);
+    const std::uint32_t *param_offsets    = reader.next(n + 1);
+    const std::uint32_t *input_offsets    = reader.next(n + 1);
+    const std::uint32_t *input_components = reader.next(n_inputs);
+    const std::uint32_t *input_outs       = reader.next(n_inputs);
+    const char          *strings          = reader.rest(header.strings_size);
+
+    check_offsets(ctype_offsets, n_ctypes, header.strings_size);
+    check_offsets(id_offsets, n, header.strings_size);
+    check_offsets(param_offsets, n, header.strings_size);
+    check_offsets(input_offsets, n, header.n_inputs);
+    if (n > 0 && input_offsets[0] != 0)
+    {
+        throw format_error("bad input offsets");
+    }
+
+    auto string_at = [strings](const std::uint32_t *offsets, size_t i)
+    {
+        return std::string_view(strings + offsets[i],
+                                offsets[i + 1] - offsets[i]);
+    };
+
+    // type table: file type index -> model::ctypes index
+    std::vector<unsigned int> ctype_indices(n_ctypes);
+    for (size_t i = 0; i < n_ctypes; ++i)
+    {
+        int ctype_idx = ctype_index(string_at(ctype_offsets, i));
+        if (ctype_idx < 0)
+        {
+            throw format_error("unknown component type " +
+                               std::string(string_at(ctype_offsets, i)));
+        }
+        ctype_indices[i] = ctype_idx;
+    }
+
+    CircuitFile circuit_file;
+    circuit_file.frequency = header.frequency;
+    circuit_file.storage   = mapped;
+    circuit_file.seed =
+      static_cast<std::uint64_t>(header.seed_high) << 32 | header.seed_low;
+    circuit_file.components.resize(n);
+    circuit_file.inputs.resize(n_inputs);
+    circuit_file.resolved_inputs.resize(n_inputs);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (ctypes[i] >= n_ctypes)
+        {
+            throw format_error("bad component type index");
+        }
+
+        ComponentRecord &record = circuit_file.components[i];
+        record.id               = string_at(id_offsets, i);
+        record.ctype_idx        = ctype_indices[ctypes[i]];
+        record.ctype            = model::ctypes[record.ctype_idx];
+        record.params           = string_at(param_offsets, i);
+        record.x                = static_cast<std::int32_t>(coordinates[2 * i]);
+        record.y = static_cast<std::int32_t>(coordinates[2 * i + 1]);
+        record.inputs_begin = input_offsets[i];
+        record.n_inputs     = input_offsets[i + 1] - input_offsets[i];
+        // binary files have no lines; use component number for errors
+        record.line = i + 1;
+    }
+
+    for (size_t i = 0; i < n_inputs; ++i)
+    {
+        if (input_components[i] == NULL_INPUT)
+        {
+            circuit_file.inputs[i]          = { true, {}, 0 };
+            circuit_file.resolved_inputs[i] = { true, 0, 0 };
+            continue;
+        }
+        if (input_components[i] >= n)
+        {
+            throw format_error("bad input component index");
+        }
+
+        circuit_file.inputs[i] = { false,
+                                   circuit_file.components[input_components[i]]
+                                     .id,
+                                   input_outs[i] };
+        circuit_file.resolved_inputs[i] = { false,
+                                            input_components[i],
+                                            input_outs[i] };
+    }
+
+    return circuit_file;
+}
+
+void write_binary(const std::string &filepath, const CircuitFile &circuit_file)
+{
+    const std::vector<ComponentRecord> &records = circuit_file.components;
+
+    Header header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version      = BINARY_VERSION;
+    header.byte_order   = BINARY_BYTE_ORDER;
+    header.frequency    = circuit_file.frequency;
+    header.seed_low     = static_cast<std::uint32_t>(circuit_file.seed);
+    header.seed_high    = static_cast<std::uint32_t>(circuit_file.seed >> 32);
+    header.n_components = records.size();
+    header.n_inputs     = circuit_file.inputs.size();
+
+    std::string                  strings;
+    std::vector<std::uint32_t>   ctype_offsets { 0 };
+    std::vector<std::uint32_t>   ctypes;
+    std::vector<std::uint32_t>   coordinates;
+    std::vector<std::uint32_t>   id_offsets, param_offsets, input_offsets;
+    std::vector<std::uint32_t>   input_components, input_outs;
+    std::unordered_map<unsigned int, std::uint32_t> ctype_table;
+    std::unordered_map<std::string_view, std::uint32_t> indices;
+
+    ctypes.reserve(records.size());
+    coordinates.reserve(2 * records.size());
+    indices.reserve(records.size());
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (!indices.emplace(records[i].id, i).second)
+        {
+            throw format_error("duplicate id " + std::string(records[i].id));
+        }
+
+        auto it = ctype_table.find(records[i].ctype_idx);
+        if (it == ctype_table.end())
+        {
+            it = ctype_table.emplace(records[i].ctype_idx, ctype_table.size())
+                   .first;
+            strings += model::ctypes[records[i].ctype_idx];
+            ctype_offsets.push_back(strings.size());
+        }
+        ctypes.push_back(it->second);
+        coordinates.push_back(static_cast<std::uint32_t>(records[i].x));
+        coordinates.push_back(static_cast<std::uint32_t>(records[i].y));
+    }
+    header.n_ctypes = ctype_table.size();
+
+    id_offsets.push_back(strings.size());
+    for (const auto &record : records)
+    {
+        strings += record.id;
+        id_offsets.push_back(strings.size());
+    }
+
+    param_offsets.push_back(strings.size());
+    input_offsets.push_back(0);
+    for (const auto &record : records)
+    {
+        strings += record.params;
+        param_offsets.push_back(strings.size());
+
+        for (size_t j = record.inputs_begin;
+             j < record.inputs_begin + record.n_inputs;
+             ++j)
+        {
+            const InputRecord &input = circuit_file.inputs[j];
+            if (input.null)
+            {
+                input_components.push_back(NULL_INPUT);
+                input_outs.push_back(0);
+                continue;
+            }
+
+            auto it = indices.find(input.id);
+            if (it == indices.end())
+            {
+                throw format_error("invalid input for component " +
+                                   std::string(record.id));
+            }
+            input_components.push_back(it->second);
+            input_outs.push_back(input.out);
+        }
+        input_offsets.push_back(input_components.size());
+    }
+    header.n_inputs     = input_components.size();
+    header.strings_size = strings.size();
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (file.fail())
+    {
+        throw std::invalid_argument("File could not be created");
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    write_values(file, ctype_offsets);
+    write_values(file, ctypes);
+    write_values(file, coordinates);
+    write_values(file, id_offsets);
+    write_values(file, param_offsets);
+    write_values(file, input_offsets);
+    write_values(file, input_components);
+    write_values(file, input_outs);
+    write_values(file, strings);
+
+    if (file.fail())
+    {
+        throw std::invalid_argument("File could not be written");
+    }
+}
+
+CircuitFile read_any(const std::string &filepath, unsigned int n_threads)
+{
+    return is_binary(filepath) ? read_binary(filepath)
+                               : read(filepath, n_threads);
+}
+}
+}
+}
@@ -23,6 +23,15 @@ void Circuit::add_component(component::Component &component)
 
     _components.push_back(&component);
     _component_ids.insert(component.id());
+    _profile_slots.clear();
+    _quiet_ticks = 0;
+    component.seed(_seed);
+}
+
+void Circuit::own_component(component::Component &component)
+{
+    add_component(component);
+    _created_components.push_back(&component);
 }
 
 void Circuit::remove_component(component::Component &component)
@@ -36,19 +45,88 @@ void Circuit::remove_component(component::Component &component)
       std::remove(_components.begin(), _components.end(), &component),
       _components.end());
     _component_ids.erase(component.id());
+    _profile_slots.clear();
+    _quiet_ticks = 0;
+
+    remove_watchpoints(component);
 }
 
 void Circuit::tick()
 {
+#ifndef LOGICSIM_NO_PROFILING
+    if (_profiling)
+    {
+        _profiled_tick();
+        return;
+    }
+#endif
+
     for (auto &target : _components)
     {
         target->update();
     }
+    bool changed = false;
     for (auto &target : _components)
     {
         target->tick();
+        changed |= target->changed();
     }
+    _end_tick(changed);
+}
+
+void Circuit::_end_tick(bool changed)
+{
     ++_total_ticks;
+    if (changed)
+    {
+        _quiet_ticks = 0;
+    }
+    else if (_quiet_ticks != std::numeric_limits<unsigned int>::max())
+    {
+        ++_quiet_ticks;
+    }
+
+    if (!_watched.empty())
+    {
+        _check_watchpoints();
+    }
+}
+
+std::uint64_t Circuit::run(std::uint64_t ticks)
+{
+    for (std::uint64_t i = 0; i < ticks; ++i)
+    {
+        tick();
+        if (!_triggered.empty())
+        {
+            return i + 1;
+        }
+    }
+
+    return ticks;
+}
+
+bool Circuit::run_until(const watch::Watchpoint &condition,
+                        std::uint64_t            max_ticks)
+{
+    unsigned int handle = add_watchpoint(condition);
+    bool         fired  = false;
+
+    for (std::uint64_t i = 0; i < max_ticks && !fired; ++i)
+    {
+        // nothing changes anymore, so neither can the condition
+        if (i != 0 && settled())
+        {
+            skip(max_ticks - i);
+            break;
+        }
+        tick();
+        fired = std::find(_triggered.begin(), _triggered.end(), handle) !=
+                _triggered.end();
+    }
+
+    remove_watchpoint(handle);
+    return fired;
 }
 
 void Circuit::check() const
@@ -66,17 +144,407 @@ void Circuit::reset()
         target->reset();
     }
     _total_ticks = 0;
+    _quiet_ticks = 0;
+
+    for (auto &watched : _watched)
+    {
+        watched.last   = State::HiZ;
+        watched.primed = false;
+    }
+    _triggered.clear();
 }
 
-unsigned int Circuit::total_ticks() const
+std::uint64_t Circuit::total_ticks() const
 {
     return _total_ticks;
 }
 
+void Circuit::set_seed(std::uint64_t seed)
+{
+    _seed = seed;
+    for (auto &component : _components)
+    {
+        component->seed(_seed);
+    }
+}
+
+std::uint64_t Circuit::seed() const
+{
+    return _seed;
+}
+
+bool Circuit::settled() const
+{
+    if (_quiet_ticks == 0)
+    {
+        return false;
+    }
+    // evaluations still in a component's history may yet become outputs
+    for (const auto &target : _components)
+    {
+        if (target->autonomous() || _quiet_ticks <= target->delay())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Circuit::skip(std::uint64_t ticks)
+{
+    _total_ticks += ticks;
+}
+
 bool Circuit::empty() const
 {
     return _components.empty();
 }
+
+size_t Circuit::size() const
+{
+    return _components.size();
+}
+
+const std::vector<component::Component *> &Circuit::components() const
+{
+    return _components;
+}
+
+void Circuit::reserve(size_t n_components)
+{
+    _components.reserve(n_components);
+    _component_ids.reserve(n_components);
+}
+
+void Circuit::set_profiling(bool enabled)
+{
+#ifndef LOGICSIM_NO_PROFILING
+    _profiling = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool Circuit::profiling() const
+{
+    return _profiling;
+}
+
+const profile::Profile &Circuit::profile() const
+{
+    return _profile;
+}
+
+void Circuit::reset_profile()
+{
+    _profile.reset();
+}
+
+void Circuit::_profiled_tick()
+{
+    typedef std::chrono::steady_clock clock;
+
+    if (_profile_slots.size() != _components.size())
+    {
+        _profile_slots.clear();
+        _profile_slots.reserve(_components.size());
+        std::vector<std::uint64_t> counts(_profile.ctypes.size());
+        for (const auto &target : _components)
+        {
+            int ctype_idx = ctype_index(target->ctype());
+            _profile_slots.push_back(ctype_idx < 0 ? profile::OTHER_CTYPE
+                                                   : ctype_idx);
+            ++counts[_profile_slots.back()];
+        }
+
+        _profile_counts.clear();
+        for (size_t slot = 0; slot < counts.size(); ++slot)
+        {
+            if (counts[slot] > 0)
+            {
+                _profile_counts.emplace_back(slot, counts[slot]);
+            }
+        }
+
+        // cheapest of a few batches, so that preemption doesn't inflate it
+        const unsigned int READS = 64;
+        _clock_overhead          = std::numeric_limits<std::uint64_t>::max();
+        for (int batch = 0; batch < 8; ++batch)
+        {
+            auto start = clock::now();
+            for (unsigned int i = 1; i < READS; ++i)
+            {
+                clock::now();
+            }
+            std::uint64_t ns =
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now() - start)
+                .count();
+            _clock_overhead = std::min(_clock_overhead, ns / READS);
+        }
+    }
+
+    for (const auto &[slot, count] : _profile_counts)
+    {
+        _profile.ctypes[slot].evaluations += count;
+    }
+
+    if (_profile.ticks++ % PROFILE_SAMPLE_INTERVAL != 0)
+    {
+        auto start = clock::now();
+        for (auto &target : _components)
+        {
+            target->update();
+        }
+        bool changed = false;
+        for (auto &target : _components)
+        {
+            target->tick();
+            changed |= target->changed();
+        }
+        _end_tick(changed);
+        _profile.tick_latency.record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() -
+                                                               start)
+            .count());
+        return;
+    }
+
+    // components of the same type next to each other are timed as a batch,
+    // so the clock is read once per run of a type rather than per component
+    // the time is scaled to the ticks that were not measured
+    auto prev = clock::now();
+    auto time = [this, &prev](unsigned int slot)
+    {
+        auto          now = clock::now();
+        std::uint64_t ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev)
+            .count();
+        if (ns > _clock_overhead)
+        {
+            _profile.ctypes[slot].nanoseconds +=
+              (ns - _clock_overhead) * PROFILE_SAMPLE_INTERVAL;
+        }
+        prev = now;
+    };
+
+    size_t n = _components.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        _components[i]->update();
+        if (i + 1 == n || _profile_slots[i + 1] != _profile_slots[i])
+        {
+            time(_profile_slots[i]);
+        }
+    }
+    bool changed = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        _components[i]->tick();
+        changed |= _components[i]->changed();
+        if (i + 1 == n || _profile_slots[i + 1] != _profile_slots[i])
+        {
+            time(_profile_slots[i]);
+        }
+    }
+    _end_tick(changed);
+}
+
+unsigned int Circuit::add_watchpoint(const watch::Watchpoint &watchpoint)
+{
+    if (watchpoint.probes.empty())
+    {
+        throw std::invalid_argument("Watchpoint has no outputs to probe");
+    }
+    for (const auto &probe : watchpoint.probes)
+    {
+        if (_component_ids.find(probe.component->id()) == _component_ids.end())
+        {
+            throw std::invalid_argument("Component not found");
+        }
+        if (probe.out >= probe.component->n_evals())
+        {
+            throw std::invalid_argument("Invalid output index");
+        }
+    }
+
+    unsigned int handle  = _next_watchpoint++;
+    _watchpoints[handle] = watchpoint;
+    _added_watchpoints.push_back(handle);
+    _rebuild_watched();
+
+    return handle;
+}
+
+void Circuit::remove_watchpoint(unsigned int handle)
+{
+    if (_watchpoints.erase(handle) == 0)
+    {
+        throw std::invalid_argument("Watchpoint not found");
+    }
+    _rebuild_watched();
+}
+
+void Circuit::remove_watchpoints(const component::Component &component)
+{
+    bool removed = false;
+    for (auto it = _watchpoints.begin(); it != _watchpoints.end();)
+    {
+        const std::vector<watch::Probe> &probes = it->second.probes;
+        if (std::any_of(probes.begin(),
+                        probes.end(),
+                        [&component](const watch::Probe &probe)
+                        { return probe.component == &component; }))
+        {
+            it      = _watchpoints.erase(it);
+            removed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (removed)
+    {
+        _rebuild_watched();
+    }
+}
+
+void Circuit::clear_watchpoints()
+{
+    _watchpoints.clear();
+    _watched.clear();
+    _triggered.clear();
+    _added_watchpoints.clear();
+}
+
+const watch::Watchpoint &Circuit::watchpoint(unsigned int handle) const
+{
+    return _watchpoints.at(handle);
+}
+
+bool Circuit::has_watchpoint(unsigned int handle) const
+{
+    return _watchpoints.find(handle) != _watchpoints.end();
+}
+
+const std::vector<unsigned int> &Circuit::triggered_watchpoints() const
+{
+    return _triggered;
+}
+
+void Circuit::_rebuild_watched()
+{
+    // outputs watched before keep their state, so that level conditions which
+    // already held do not fire again
+    std::vector<WatchedOutput> previous = std::move(_watched);
+    _watched.clear();
+    _triggered.clear();
+
+    for (const auto &[handle, watchpoint] : _watchpoints)
+    {
+        for (const auto &probe : watchpoint.probes)
+        {
+            auto it = std::find_if(_watched.begin(),
+                                   _watched.end(),
+                                   [&probe](const WatchedOutput &watched)
+                                   {
+                                       return watched.probe.component ==
+                                                probe.component &&
+                                              watched.probe.out == probe.out;
+                                   });
+            if (it == _watched.end())
+            {
+                auto prev_it = std::find_if(
+                  previous.begin(),
+                  previous.end(),
+                  [&probe](const WatchedOutput &watched)
+                  {
+                      return watched.probe.component == probe.component &&
+                             watched.probe.out == probe.out;
+                  });
+                if (prev_it != previous.end())
+                {
+                    _watched.push_back(
+                      { probe, prev_it->last, prev_it->primed, {} });
+                }
+                else
+                {
+                    // edge conditions compare against the current value
+                    _watched.push_back({ probe,
+                                         probe.component->evaluate(probe.out),
+                                         false,
+                                         {} });
+                }
+                it = _watched.end() - 1;
+            }
+            if (it->watchpoints.empty() || it->watchpoints.back() != handle)
+            {
+                it->watchpoints.push_back(handle);
+            }
+        }
+    }
+}
+
+void Circuit::_check_watchpoints()
+{
+    _triggered.clear();
+
+    // patterns span several outputs, so they are checked after all watched
+    // outputs have been updated
+    std::vector<unsigned int> changed_patterns;
+
+    for (auto &watched : _watched)
+    {
+        State curr    = watched.probe.component->evaluate(watched.probe.out);
+        bool  changed = !watched.primed || curr != watched.last;
+        if (!changed && _added_watchpoints.empty())
+        {
+            continue;
+        }
+
+        State prev     = watched.last;
+        watched.last   = curr;
+        watched.primed = true;
+
+        for (const auto &handle : watched.watchpoints)
+        {
+            // watchpoints added on an output that was already watched are
+            // checked once, even if it did not change
+            if (!changed && std::find(_added_watchpoints.begin(),
+                                      _added_watchpoints.end(),
+                                      handle) == _added_watchpoints.end())
+            {
+                continue;
+            }
+            const watch::Watchpoint &watchpoint = _watchpoints.at(handle);
+            if (watchpoint.type == watch::PATTERN)
+            {
+                changed_patterns.push_back(handle);
+            }
+            else if (watchpoint.fires(prev, curr))
+            {
+                _triggered.push_back(handle);
+            }
+        }
+    }
+
+    std::sort(changed_patterns.begin(), changed_patterns.end());
+    changed_patterns.erase(
+      std::unique(changed_patterns.begin(), changed_patterns.end()),
+      changed_patterns.end());
+    for (const auto &handle : changed_patterns)
+    {
+        if (_watchpoints.at(handle).matches())
+        {
+            _triggered.push_back(handle);
+        }
+    }
+
+    _added_watchpoints.clear();
+}
 }
 }
 }
@@ -0,0 +1,618 @@
+#include "model/circuit_file.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+namespace
+{
+// files and circuits smaller than these are processed on a single thread
+constexpr size_t PARALLEL_MIN_SIZE       = 1 << 20;
+constexpr size_t PARALLEL_MIN_COMPONENTS = 1 << 14;
+
+// threads to use for n_components components, given n_threads requested
+unsigned int component_threads(size_t n_components, unsigned int n_threads)
+{
+    return n_components < PARALLEL_MIN_COMPONENTS ? 1
+                                                  : utils::thread_count(
+                                                      n_threads);
+}
+
+std::invalid_argument line_error(size_t line, const std::string &message)
+{
+    return std::invalid_argument("Invalid file format: line " +
+                                 std::to_string(line) + " " + message);
+}
+
+std::invalid_argument component_error(const std::string &message,
+                                      std::string_view   id)
+{
+    return std::invalid_argument("Invalid file format: " + message + " " +
+                                 std::string(id));
+}
+
+// parses whole of str as an integer
+template <typename T> bool parse_int(std::string_view str, T &value)
+{
+    const char *end = str.data() + str.size();
+    auto [ptr, ec]  = std::from_chars(str.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+void delete_components(std::vector<component::Component *> &components)
+{
+    for (auto &component : components)
+    {
+        delete component;
+    }
+    components.clear();
+}
+
+// returns the next line of contents, starting from pos, without its line
+// ending, or false if there are no more lines
+bool get_line(std::string_view contents, size_t &pos, std::string_view &line)
+{
+    if (pos >= contents.size())
+    {
+        return false;
+    }
+    size_t end = contents.find('\n', pos);
+    if (end == std::string_view::npos)
+    {
+        end = contents.size();
+    }
+    line = contents.substr(pos, end - pos);
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    pos = end + 1;
+    return true;
+}
+
+// parses component lines, the first of which is line first_line of the file
+// records are appended to components, and their inputs to inputs
+void parse_lines(std::string_view lines, size_t first_line,
+                 std::vector<ComponentRecord> &components,
+                 std::vector<InputRecord>     &inputs)
+{
+    size_t           pos = 0;
+    std::string_view line;
+
+    utils::StringViewSplitter splitter, splitter2, splitter3;
+
+    for (size_t i = first_line; get_line(lines, pos, line); ++i)
+    {
+        ComponentRecord record;
+        record.line = i;
+
+        splitter.reset(line, ';');
+
+        record.id = splitter.next();
+        if (record.id.empty())
+        {
+            throw line_error(i, "empty");
+        }
+
+        if (!splitter.has_next() || (record.ctype = splitter.next()).empty())
+        {
+            throw line_error(i, "missing component type");
+        }
+        int ctype_idx = ctype_index(record.ctype);
+        if (ctype_idx < 0)
+        {
+            throw line_error(i, "unknown component type");
+        }
+        record.ctype_idx = ctype_idx;
+
+        if (!splitter.has_next())
+        {
+            throw line_error(i, "missing parameters");
+        }
+        record.params = splitter.next();
+
+        if (!splitter.has_next())
+        {
+            throw line_error(i, "missing coordinates");
+        }
+
+        splitter2.reset(splitter.next(), ',');
+        if (!parse_int(splitter2.next(), record.x))
+        {
+            throw line_error(i, "bad coordinate");
+        }
+        if (!splitter2.has_next())
+        {
+            throw line_error(i, "missing coordinate 2");
+        }
+        if (!parse_int(splitter2.next(), record.y))
+        {
+            throw line_error(i, "bad coordinate");
+        }
+        if (splitter2.has_next())
+        {
+            throw line_error(i, "too many fields");
+        }
+
+        if (!splitter.has_next())
+        {
+            throw line_error(i, "missing inputs");
+        }
+
+        std::string_view inputs_str = splitter.next();
+
+        if (splitter.has_next())
+        {
+            throw line_error(i, "too many fields");
+        }
+
+        record.inputs_begin = inputs.size();
+        record.n_inputs     = 0;
+
+        if (!inputs_str.empty())
+        {
+            splitter2.reset(inputs_str, ',');
+            while (splitter2.has_next())
+            {
+                std::string_view input_str = splitter2.next();
+                ++record.n_inputs;
+
+                if (input_str == "NULL")
+                {
+                    inputs.push_back({ true, {}, 0 });
+                    continue;
+                }
+
+                splitter3.reset(input_str, ':');
+                std::string_view input_id = splitter3.next();
+                if (input_id.empty() || !splitter3.has_next())
+                {
+                    throw component_error("invalid input for component",
+                                          record.id);
+                }
+
+                unsigned int out;
+                if (!parse_int(splitter3.next(), out))
+                {
+                    throw component_error("invalid output index for component",
+                                          record.id);
+                }
+                if (splitter3.has_next())
+                {
+                    throw component_error("too many fields for input of",
+                                          record.id);
+                }
+
+                inputs.push_back({ false, input_id, out });
+            }
+        }
+
+        components.push_back(record);
+    }
+
+}
+
+// parses component lines on multiple threads
+// lines are split into line-aligned chunks; line numbers of each chunk are
+// found by counting its lines first, so that errors refer to the right line
+// if multiple lines are invalid, the error of the first one is thrown
+void parse_lines_parallel(std::string_view lines, unsigned int n_threads,
+                          CircuitFile &circuit_file)
+{
+    struct Chunk
+    {
+        std::string_view             lines;
+        size_t                       first_line;
+        std::vector<ComponentRecord> components;
+        std::vector<InputRecord>     inputs;
+        // position of chunk records in the whole file
+        size_t components_begin;
+        size_t inputs_begin;
+    };
+
+    size_t             n_chunks = utils::thread_count(n_threads);
+    std::vector<Chunk> chunks(n_chunks);
+
+    size_t begin = 0;
+    for (size_t c = 0; c < n_chunks; ++c)
+    {
+        size_t end = lines.size();
+        if (c < n_chunks - 1)
+        {
+            end = lines.find('\n', std::max(begin, (c + 1) * lines.size() /
+                                                      n_chunks));
+            end = end == std::string_view::npos ? lines.size() : end + 1;
+        }
+        chunks[c].lines = lines.substr(begin, end - begin);
+        begin           = end;
+    }
+
+    std::vector<size_t> n_lines(n_chunks);
+    utils::parallel_for(n_chunks,
+                        n_chunks,
+                        [&chunks, &n_lines](size_t begin, size_t end)
+                        {
+                            for (size_t c = begin; c < end; ++c)
+                            {
+                                n_lines[c] = std::count(chunks[c].lines.begin(),
+                                                        chunks[c].lines.end(),
+                                                        '\n') +
+                                             1;
+                            }
+                        });
+
+    // every chunk but the last ends with a line ending
+    chunks[0].first_line = 1;
+    for (size_t c = 1; c < n_chunks; ++c)
+    {
+        chunks[c].first_line = chunks[c - 1].first_line + n_lines[c - 1] - 1;
+    }
+
+    utils::parallel_for(n_chunks,
+                        n_chunks,
+                        [&chunks, &n_lines](size_t begin, size_t end)
+                        {
+                            for (size_t c = begin; c < end; ++c)
+                            {
+                                Chunk &chunk = chunks[c];
+                                chunk.components.reserve(n_lines[c]);
+                                chunk.inputs.reserve(2 * n_lines[c]);
+                                parse_lines(chunk.lines,
+                                            chunk.first_line,
+                                            chunk.components,
+                                            chunk.inputs);
+                            }
+                        });
+
+    size_t n_components = 0, n_inputs = 0;
+    for (auto &chunk : chunks)
+    {
+        chunk.components_begin = n_components;
+        chunk.inputs_begin     = n_inputs;
+        n_components += chunk.components.size();
+        n_inputs += chunk.inputs.size();
+    }
+
+    circuit_file.components.resize(n_components);
+    circuit_file.inputs.resize(n_inputs);
+
+    utils::parallel_for(
+      n_chunks,
+      n_chunks,
+      [&chunks, &circuit_file](size_t begin, size_t end)
+      {
+          for (size_t c = begin; c < end; ++c)
+          {
+              const Chunk &chunk = chunks[c];
+              std::copy(chunk.inputs.begin(),
+                        chunk.inputs.end(),
+                        circuit_file.inputs.begin() + chunk.inputs_begin);
+              for (size_t i = 0; i < chunk.components.size(); ++i)
+              {
+                  ComponentRecord &record =
+                    circuit_file.components[chunk.components_begin + i];
+                  record = chunk.components[i];
+                  record.inputs_begin += chunk.inputs_begin;
+              }
+          }
+      });
+}
+
+CircuitFile parse_contents(std::string_view            contents,
+                           std::shared_ptr<const void> storage,
+                           unsigned int                n_threads)
+{
+    CircuitFile circuit_file;
+    circuit_file.storage = std::move(storage);
+
+    size_t           pos = 0;
+    std::string_view line;
+    get_line(contents, pos, line);
+
+    // seed is optional, for files saved before it was
+    std::string_view frequency = line.substr(0, line.find(';'));
+    if (!utils::is_positive_int(frequency) ||
+        !parse_int(frequency, circuit_file.frequency))
+    {
+        throw std::invalid_argument("Invalid file format: invalid frequency");
+    }
+    if (frequency.size() < line.size() &&
+        !parse_int(line.substr(frequency.size() + 1), circuit_file.seed))
+    {
+        throw std::invalid_argument("Invalid file format: invalid seed");
+    }
+
+    std::string_view lines = contents.substr(std::min(pos, contents.size()));
+
+    if (lines.size() >= PARALLEL_MIN_SIZE && utils::thread_count(n_threads) > 1)
+    {
+        parse_lines_parallel(lines, n_threads, circuit_file);
+        return circuit_file;
+    }
+
+    size_t n_lines = std::count(lines.begin(), lines.end(), '\n') + 1;
+    circuit_file.components.reserve(n_lines);
+    circuit_file.inputs.reserve(2 * n_lines);
+
+    parse_lines(lines, 1, circuit_file.components, circuit_file.inputs);
+
+    return circuit_file;
+}
+}
+
+CircuitFile read(const std::string &filepath, unsigned int n_threads)
+{
+    std::shared_ptr<const MappedFile> file =
+      std::make_shared<const MappedFile>(filepath);
+
+    return parse_contents(file->view(), file, n_threads);
+}
+
+CircuitFile parse(std::string contents, unsigned int n_threads)
+{
+    std::shared_ptr<const std::string> owned =
+      std::make_shared<const std::string>(std::move(contents));
+
+    return parse_contents(*owned, owned, n_threads);
+}
+
+void write(const std::string &filepath, const CircuitFile &circuit_file)
+{
+    std::ofstream file(filepath);
+
+    if (file.fail())
+    {
+        throw std::invalid_argument("File could not be created");
+    }
+
+    write(file, circuit_file);
+}
+
+void write(std::ostream &stream, const CircuitFile &circuit_file)
+{
+    stream << circuit_file.frequency << ';' << circuit_file.seed << "\n";
+
+    for (const auto &record : circuit_file.components)
+    {
+        stream << record.id << ';' << record.ctype << ';' << record.params
+               << ';' << record.x << ',' << record.y << ';';
+
+        for (unsigned int i = 0; i < record.n_inputs; ++i)
+        {
+            const InputRecord &input =
+              circuit_file.inputs[record.inputs_begin + i];
+            if (input.null)
+            {
+                stream << "NULL";
+            }
+            else
+            {
+                stream << input.id << ':' << input.out;
+            }
+            if (i < record.n_inputs - 1)
+            {
+                stream << ',';
+            }
+        }
+
+        stream << "\n";
+    }
+}
+
+std::string record_params(const ComponentRecord &record)
+{
+    if (!record.params.empty() || record.ctype != "RANDOM")
+    {
+        return std::string(record.params);
+    }
+
+    // FNV-1a, which unlike std::hash is the same on every platform
+    std::uint64_t stream = 0xCBF29CE484222325;
+    for (char c : record.id)
+    {
+        stream = (stream ^ static_cast<unsigned char>(c)) * 0x100000001B3;
+    }
+    return std::to_string(stream);
+}
+
+std::vector<ResolvedInput>
+resolve_inputs(const CircuitFile                         &circuit_file,
+               const std::vector<component::Component *> &components,
+               unsigned int                               n_threads)
+{
+    const std::vector<ComponentRecord> &records = circuit_file.components;
+
+    n_threads = component_threads(records.size(), n_threads);
+
+    // inputs of binary files refer to components by index, and only need to be
+    // checked
+    bool by_id = circuit_file.resolved_inputs.empty();
+
+    // ids are split among shards by hash, so that each shard can be built by
+    // its own thread
+    using IndexMap = std::unordered_map<std::string_view, size_t>;
+    std::hash<std::string_view> hash;
+    size_t                      n_shards = by_id ? n_threads : 0;
+    std::vector<IndexMap>       shards(n_shards);
+
+    if (by_id)
+    {
+        std::vector<size_t> hashes(records.size());
+        utils::parallel_for(records.size(),
+                            n_threads,
+                            [&records, &hashes, &hash](size_t begin, size_t end)
+                            {
+                                for (size_t i = begin; i < end; ++i)
+                                {
+                                    hashes[i] = hash(records[i].id);
+                                }
+                            });
+
+        // first duplicate of each shard
+        std::vector<size_t> duplicates(n_shards, records.size());
+        utils::parallel_for(
+          n_shards,
+          n_shards,
+          [&](size_t begin, size_t end)
+          {
+              for (size_t shard = begin; shard < end; ++shard)
+              {
+                  IndexMap &indices = shards[shard];
+                  indices.reserve(records.size() / n_shards + 1);
+                  for (size_t i = 0; i < records.size(); ++i)
+                  {
+                      if (hashes[i] % n_shards == shard &&
+                          !indices.emplace(records[i].id, i).second)
+                      {
+                          duplicates[shard] = i;
+                          break;
+                      }
+                  }
+              }
+          });
+
+        size_t duplicate =
+          *std::min_element(duplicates.begin(), duplicates.end());
+        if (duplicate < records.size())
+        {
+            throw line_error(records[duplicate].line, "duplicate id");
+        }
+    }
+
+    std::vector<ResolvedInput> resolved =
+      by_id ? std::vector<ResolvedInput>(circuit_file.inputs.size())
+            : circuit_file.resolved_inputs;
+
+    utils::parallel_for(
+      records.size(),
+      n_threads,
+      [&](size_t begin, size_t end)
+      {
+          for (size_t i = begin; i < end; ++i)
+          {
+              const ComponentRecord &record   = records[i];
+              unsigned int           n_inputs = components[i]->n_inputs();
+
+              if (record.n_inputs > n_inputs)
+              {
+                  throw component_error("too many inputs for component",
+                                        record.id);
+              }
+              if (record.n_inputs < n_inputs)
+              {
+                  throw component_error("missing inputs for component",
+                                        record.id);
+              }
+
+              for (size_t j = record.inputs_begin;
+                   j < record.inputs_begin + record.n_inputs;
+                   ++j)
+              {
+                  const InputRecord &input = circuit_file.inputs[j];
+                  if (input.null)
+                  {
+                      resolved[j] = { true, 0, 0 };
+                      continue;
+                  }
+
+                  if (by_id)
+                  {
+                      const IndexMap &indices =
+                        shards[hash(input.id) % n_shards];
+                      auto it = indices.find(input.id);
+                      if (it == indices.end())
+                      {
+                          throw component_error("invalid input for component",
+                                                record.id);
+                      }
+                      resolved[j] = { false, it->second, input.out };
+                  }
+
+                  if (input.out >=
+                      components[resolved[j].component_idx]->n_outputs())
+                  {
+                      throw component_error(
+                        "invalid output index for component", record.id);
+                  }
+              }
+          }
+      });
+
+    return resolved;
+}
+
+std::vector<component::Component *> load(const CircuitFile &circuit_file,
+                                         circuit::Circuit  &circuit,
+                                         unsigned int       n_threads)
+{
+    const std::vector<ComponentRecord> &records = circuit_file.components;
+
+    n_threads = component_threads(records.size(), n_threads);
+
+    std::vector<component::Component *> components(records.size(), nullptr);
+
+    std::vector<ResolvedInput> resolved;
+    try
+    {
+        utils::parallel_for(
+          records.size(),
+          n_threads,
+          [&records, &components](size_t begin, size_t end)
+          {
+              for (size_t i = begin; i < end; ++i)
+              {
+                  components[i] = ctype_factories[records[i].ctype_idx]();
+                  try
+                  {
+                      components[i]->set_params(record_params(records[i]));
+                  }
+                  catch (const std::logic_error &)
+                  {
+                      throw line_error(records[i].line, "bad parameters");
+                  }
+              }
+          });
+
+        resolved = resolve_inputs(circuit_file, components, n_threads);
+    }
+    catch (const std::invalid_argument &)
+    {
+        delete_components(components);
+        throw;
+    }
+
+    utils::parallel_for(
+      records.size(),
+      n_threads,
+      [&records, &components, &resolved](size_t begin, size_t end)
+      {
+          for (size_t i = begin; i < end; ++i)
+          {
+              const ComponentRecord &record = records[i];
+              for (unsigned int j = 0; j < record.n_inputs; ++j)
+              {
+                  const ResolvedInput &input = resolved[record.inputs_begin + j];
+                  if (input.null)
+                  {
+                      continue;
+                  }
+                  static_cast<component::NInputComponent *>(components[i])
+                    ->set_input(j, *components[input.component_idx], input.out);
+              }
+          }
+      });
+
+    circuit.reserve(circuit.size() + components.size());
+    for (auto &component : components)
+    {
+        circuit.own_component(*component);
+    }
+    circuit.set_seed(circuit_file.seed);
+
+    return components;
+}
+}
+}
+}
@@ -12,7 +12,7 @@ const char *null_input::what() const noexcept
 }
 
 // Component
-unsigned int Component::_CURR_ID = 0;
+std::atomic<unsigned int> Component::_CURR_ID(0);
 
 Component::Component(unsigned int delay, unsigned int n_evals)
   : _history_size(delay + 1)
@@ -26,14 +26,12 @@ Component::~Component() {}
 
 void Component::tick()
 {
-    for (size_t i = 0; i < _n_evals; ++i)
-    {
-        _cache_history.front()[i] = _evaluate(i);
-    }
+    _store_evaluations([this](unsigned int out) { return _evaluate(out); });
 }
 
 void Component::update()
 {
+    _changed = false;
     if (_history_size > 1)
     {
         std::vector<State> back = std::move(_cache_history.back());
@@ -51,8 +49,25 @@ State Component::evaluate(unsigned int out)
     return _cache_history.back()[out];
 }
 
+bool Component::changed() const
+{
+    return _changed;
+}
+
+bool Component::autonomous() const
+{
+    return false;
+}
+
+unsigned int Component::delay() const
+{
+    return _history_size - 1;
+}
+
 void Component::check() const {}
 
+void Component::seed(std::uint64_t) {}
+
 void Component::reset()
 {
     std::list<std::vector<State>>::iterator it;
@@ -207,6 +222,11 @@ void TimeComponent::reset()
     Component::reset();
 }
 
+bool TimeComponent::autonomous() const
+{
+    return true;
+}
+
 // ClockedComponent
 ClockedComponent::ClockedComponent(unsigned int clk_idx)
 {
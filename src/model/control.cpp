@@ -7,34 +7,14 @@ namespace model
 namespace control
 {
 // Multiplexer
-Multiplexer::Multiplexer(unsigned int bits)
-  : NInputComponent(bits + std::pow(2, bits) + 1, 5, 1)
-  , _bits(bits)
-  , _S(std::vector<Component **>(bits))
-  , _S_out(std::vector<unsigned int *>(bits))
-  , _D(std::vector<Component **>(n_inputs() - bits - 1))
-  , _D_out(std::vector<unsigned int *>(n_inputs() - bits - 1))
+template <unsigned int BITS>
+Multiplexer<BITS>::Multiplexer() : NInputComponent(SELECT + BITS, 5, 1)
 {
-    _E     = &_inputs[0];
-    _E_out = &_inputs_out[0];
-
-    const unsigned int ds = _D.size();
-    for (unsigned int i = 0; i < ds; ++i)
-    {
-        _D[i]     = &_inputs[i + 1];
-        _D_out[i] = &_inputs_out[i + 1];
-    }
-
-    for (unsigned int i = 0; i < bits; ++i)
-    {
-        _S[i]     = &_inputs[ds + i + 1];
-        _S_out[i] = &_inputs_out[ds + i + 1];
-    }
 }
 
-State Multiplexer::_evaluate(unsigned int)
+template <unsigned int BITS> State Multiplexer<BITS>::_evaluate(unsigned int)
 {
-    switch ((*_E)->evaluate(*_E_out))
+    switch (_inputs[0]->evaluate(_inputs_out[0]))
     {
     case State::ONE:
         return State::ZERO;
@@ -44,78 +24,87 @@ State Multiplexer::_evaluate(unsigned int)
         break;
     }
 
+    // BITS is known here, so the loop is unrolled
     unsigned int idx = 0;
-    for (unsigned int i = 0; i < _bits; ++i)
+    for (unsigned int i = SELECT; i < SELECT + BITS; ++i)
     {
-        State s = (*_S[i])->evaluate(*_S_out[i]);
+        State s = _inputs[i]->evaluate(_inputs_out[i]);
         if (s == State::HiZ)
         {
             return State::HiZ;
         }
-        idx += s * std::pow(2, _bits - 1 - i);
+        idx = (idx << 1) | s;
     }
 
-    return (*_D[idx])->evaluate(*_D_out[idx]);
+    return _inputs[DATA + idx]->evaluate(_inputs_out[DATA + idx]);
 }
 
-std::string Multiplexer::ctype() const
+template <unsigned int BITS> std::string Multiplexer<BITS>::ctype() const
 {
-    return "MUX-" + std::to_string(_bits);
+    return "MUX-" + std::to_string(BITS);
 }
 
 // Decoder
-Decoder::Decoder(unsigned int bits)
-  : NInputComponent(bits + 1, 5, std::pow(2, bits))
-  , _bits(bits)
-  , _outputs(std::pow(2, _bits))
-  , _B(std::vector<Component **>(_bits))
-  , _B_out(std::vector<unsigned int *>(_bits))
+template <unsigned int BITS>
+Decoder<BITS>::Decoder() : NInputComponent(BITS + 1, 5, OUTPUTS)
 {
-    _E     = &_inputs[_inputs.size() - 1];
-    _E_out = &_inputs_out[_inputs.size() - 1];
-
-    for (unsigned int i = 0; i < bits; ++i)
-    {
-        _B[i]     = &_inputs[i];
-        _B_out[i] = &_inputs_out[i];
-    }
 }
 
-State Decoder::_evaluate(unsigned int out)
+template <unsigned int BITS> void Decoder<BITS>::tick()
 {
-    switch ((*_E)->evaluate(*_E_out))
+    switch (_inputs[ENABLE]->evaluate(_inputs_out[ENABLE]))
     {
     case State::ONE:
-        return State::ZERO;
+        _state = State::ZERO;
+        break;
     case State::HiZ:
-        return State::HiZ;
-    default:
+        _state = State::HiZ;
         break;
-    }
-
-    unsigned int idx = 0;
-    for (unsigned int i = 0; i < _bits; ++i)
-    {
-        State s = (*_B[i])->evaluate(*_B_out[i]);
-        if (s == State::HiZ)
+    default:
+        _state    = State::ONE;
+        _selected = 0;
+        for (unsigned int i = 0; i < BITS; ++i)
         {
-            return State::HiZ;
+            State s = _inputs[i]->evaluate(_inputs_out[i]);
+            if (s == State::HiZ)
+            {
+                _state = State::HiZ;
+                break;
+            }
+            _selected |= static_cast<unsigned int>(s) << i;
         }
-        idx += s * std::pow(2, i);
+        break;
     }
 
-    return static_cast<State>(out == idx);
+    // all outputs in one pass; the qualified call is not virtual, so it is
+    // inlined
+    _store_evaluations([this](unsigned int out)
+                       { return Decoder::_evaluate(out); });
+}
+
+template <unsigned int BITS> State Decoder<BITS>::_evaluate(unsigned int out)
+{
+    return _state == State::ONE ? static_cast<State>(out == _selected)
+                                : _state;
 }
 
-unsigned int Decoder::n_outputs() const
+template <unsigned int BITS> unsigned int Decoder<BITS>::n_outputs() const
 {
-    return _outputs;
+    return OUTPUTS;
 }
 
-std::string Decoder::ctype() const
+template <unsigned int BITS> std::string Decoder<BITS>::ctype() const
 {
-    return "DEC-" + std::to_string(_bits);
+    return "DEC-" + std::to_string(BITS);
 }
+
+template class Multiplexer<1>;
+template class Multiplexer<2>;
+template class Multiplexer<3>;
+
+template class Decoder<1>;
+template class Decoder<2>;
+template class Decoder<3>;
 }
 }
 }
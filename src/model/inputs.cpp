@@ -174,9 +174,9 @@ unsigned int Keypad::n_outputs() const
 Random::Random()
   : NInputComponent(1, 0, 4)
   , component::EdgeTriggeredComponent(0)
-  , _rng(_dev())
-  , _state_dist(0, 1)
 {
+    thread_local std::mt19937_64 streams(std::random_device{}());
+    _stream = streams();
 }
 
 void Random::tick()
@@ -192,6 +192,12 @@ void Random::reset()
     {
         _stored[i] = State::HiZ;
     }
+    _draws = 0;
+}
+
+void Random::seed(std::uint64_t seed)
+{
+    _seed = seed;
 }
 
 unsigned int Random::n_outputs() const
@@ -204,13 +210,28 @@ std::string Random::ctype() const
     return "RANDOM";
 }
 
+std::string Random::param_string() const
+{
+    return std::to_string(_stream);
+}
+
+void Random::set_params(const std::string &param_string)
+{
+    // empty: keeps the stream picked when the component was created
+    if (!param_string.empty())
+    {
+        _stream = std::stoull(param_string);
+    }
+}
+
 State Random::_evaluate(unsigned int out)
 {
     if (_clk_edge() && !_evaluated)
     {
+        random::PhiloxCounter bits = random::philox(_stream, _draws++, _seed);
         for (int i = 0; i < 4; ++i)
         {
-            _stored[i] = static_cast<State>(_state_dist(_rng));
+            _stored[i] = static_cast<State>(bits[i] & 1);
         }
         _evaluated = true;
     }
@@ -0,0 +1,79 @@
+#include "model/mapped_file.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace file
+{
+MappedFile::MappedFile(const std::string &filepath)
+{
+#ifdef LOGICSIM_HAVE_MMAP
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::invalid_argument("File not found");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            // files are read front to back
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            _data   = static_cast<const char *>(addr);
+            _size   = st.st_size;
+            _mapped = true;
+        }
+    }
+    close(fd);
+
+    if (_mapped)
+    {
+        return;
+    }
+#endif
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (file.fail())
+    {
+        throw std::invalid_argument("File not found");
+    }
+
+    _buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(_buffer.data(), _buffer.size());
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef LOGICSIM_HAVE_MMAP
+    if (_mapped)
+    {
+        munmap(const_cast<char *>(_data), _size);
+    }
+#endif
+}
+
+const char *MappedFile::data() const
+{
+    return _data;
+}
+
+size_t MappedFile::size() const
+{
+    return _size;
+}
+
+std::string_view MappedFile::view() const
+{
+    return { _data, _size };
+}
+}
+}
+}
@@ -8,36 +8,20 @@ namespace model
 namespace memory
 {
 // MemoryComponent
-MemoryComponent::MemoryComponent()
+MemoryComponent::MemoryComponent(MemoryType type, Trigger trigger)
+  : NInputComponent(
+      type == MemoryType::SR || type == MemoryType::JK ? 5 : 4, 5, 2)
+  , _type(type)
+  , _trigger(trigger)
+  , _clk(_n - 2)
+  , _clr(_n - 1)
 {
-    int s    = _inputs.size();
-    _pre     = &_inputs[0];
-    _pre_out = &_inputs_out[0];
-    _clr     = &_inputs[s - 1];
-    _clr_out = &_inputs_out[s - 1];
 }
 
 void MemoryComponent::tick()
 {
-    _evaluated = false;
-    Component::tick();
-}
-
-void MemoryComponent::reset()
-{
-    Component::reset();
-    _Q = State::HiZ;
-}
-
-unsigned int MemoryComponent::n_outputs() const
-{
-    return 2;
-}
-
-State MemoryComponent::_evaluate(unsigned int out)
-{
-    State pre = (*_pre)->evaluate(*_pre_out);
-    State clr = (*_clr)->evaluate(*_clr_out);
+    State pre = _inputs[PRE]->evaluate(_inputs_out[PRE]);
+    State clr = _inputs[_clr]->evaluate(_inputs_out[_clr]);
 
     // override HiZ to 0, so unconnected lines do not affect function
     pre = pre == State::HiZ ? State::ZERO : pre;
@@ -45,118 +29,107 @@ State MemoryComponent::_evaluate(unsigned int out)
 
     if (pre ^ clr)
     {
-        _Q = pre ? State::ONE : State::ZERO;
-        return static_cast<State>(out) ^ _Q;
+        _Q = pre;
     }
-
-    if (pre)
+    else if (pre)
     {
         _Q = State::HiZ;
-        return static_cast<State>(out) ^ _Q;
     }
-
-    if (!_evaluated)
+    else if (_clk_edge())
     {
-        _memory_evaluate();
-        _evaluated = true;
+        // SR and JK have a second data input (R or K) before the clock
+        State x = _inputs[DATA]->evaluate(_inputs_out[DATA]);
+        State y = _clk == DATA + 2
+                    ? _inputs[DATA + 1]->evaluate(_inputs_out[DATA + 1])
+                    : State::HiZ;
+        switch (_type)
+        {
+        case MemoryType::SR:
+            _Q = x || (_Q && !y);
+            break;
+        case MemoryType::JK:
+            _Q = (!y && _Q) || (x && !_Q);
+            break;
+        case MemoryType::D:
+            _Q = x;
+            break;
+        case MemoryType::T:
+            _Q = _Q ^ x;
+            break;
+        }
     }
 
-    return static_cast<State>(out) ^ _Q;
-}
-
-// SRMemoryComponent
-SRMemoryComponent::SRMemoryComponent()
-{
-    _S     = &_inputs[1];
-    _S_out = &_inputs_out[1];
-    _R     = &_inputs[2];
-    _R_out = &_inputs_out[2];
-}
-
-void SRMemoryComponent::_memory_evaluate()
-{
-    _Q = (*_S)->evaluate(*_S_out) || (_Q && !(*_R)->evaluate(*_R_out));
-}
-
-// JKMemoryComponent
-JKMemoryComponent::JKMemoryComponent()
-{
-    _J     = &_inputs[1];
-    _J_out = &_inputs_out[1];
-    _K     = &_inputs[2];
-    _K_out = &_inputs_out[2];
+    Component::tick();
 }
 
-void JKMemoryComponent::_memory_evaluate()
+void MemoryComponent::reset()
 {
-    _Q = (!(*_K)->evaluate(*_K_out) && _Q) || ((*_J)->evaluate(*_J_out) && !_Q);
+    Component::reset();
+    _Q = State::HiZ;
 }
 
-// DMemoryComponent
-DMemoryComponent::DMemoryComponent()
+unsigned int MemoryComponent::n_outputs() const
 {
-    _D     = &_inputs[1];
-    _D_out = &_inputs_out[1];
+    return 2;
 }
 
-void DMemoryComponent::_memory_evaluate()
+bool MemoryComponent::_clk_edge()
 {
-    _Q = (*_D)->evaluate(*_D_out);
-}
+    bool clk = _inputs[_clk]->evaluate(_inputs_out[_clk]) == State::ONE;
+    if (_trigger == Trigger::LEVEL)
+    {
+        return clk;
+    }
 
-// TMemoryComponent
-TMemoryComponent::TMemoryComponent()
-{
-    _T     = &_inputs[1];
-    _T_out = &_inputs_out[1];
+    bool prev_clk = _prev_clk;
+    _prev_clk     = clk;
+    return !prev_clk && clk;
 }
 
-void TMemoryComponent::_memory_evaluate()
+State MemoryComponent::_evaluate(unsigned int out)
 {
-    _Q = _Q ^ (*_T)->evaluate(*_T_out);
+    return static_cast<State>(out) ^ _Q;
 }
 
 // Component Types for implementations
 
+/* Implements a defined memory component
+ * Inputs:
+ *  * The class name
+ *  * The memory type
+ *  * The trigger
+ *  * The ctype string
+ */
+#define IMPLEMENT_MEMORY(name, type, trigger, ctype_str) \
+    name::name() : MemoryComponent(type, trigger) {}     \
+    std::string name::ctype() const                      \
+    {                                                    \
+        return ctype_str;                                \
+    }
+
 // SRLatch
-IMPLEMENT_CLOCKED_MEMORY(SRLatch, SRMemoryComponent,
-                         component::LevelTriggeredComponent, 5, 5, 2, 3,
-                         "SRLATCH")
+IMPLEMENT_MEMORY(SRLatch, MemoryType::SR, Trigger::LEVEL, "SRLATCH")
 
 // JKLatch
-IMPLEMENT_CLOCKED_MEMORY(JKLatch, JKMemoryComponent,
-                         component::LevelTriggeredComponent, 5, 5, 2, 3,
-                         "JKLATCH")
+IMPLEMENT_MEMORY(JKLatch, MemoryType::JK, Trigger::LEVEL, "JKLATCH")
 
 // DLatch
-IMPLEMENT_CLOCKED_MEMORY(DLatch, DMemoryComponent,
-                         component::LevelTriggeredComponent, 4, 5, 2, 2,
-                         "DLATCH")
+IMPLEMENT_MEMORY(DLatch, MemoryType::D, Trigger::LEVEL, "DLATCH")
 
 // TLatch
-IMPLEMENT_CLOCKED_MEMORY(TLatch, TMemoryComponent,
-                         component::LevelTriggeredComponent, 4, 5, 2, 2,
-                         "TLATCH")
+IMPLEMENT_MEMORY(TLatch, MemoryType::T, Trigger::LEVEL, "TLATCH")
 
 // SRFlipFlop
-IMPLEMENT_CLOCKED_MEMORY(SRFlipFlop, SRMemoryComponent,
-                         component::EdgeTriggeredComponent, 5, 5, 2, 3,
-                         "SRFLIPFLOP")
+IMPLEMENT_MEMORY(SRFlipFlop, MemoryType::SR, Trigger::EDGE, "SRFLIPFLOP")
 
 // JKFlipFlop
-IMPLEMENT_CLOCKED_MEMORY(JKFlipFlop, JKMemoryComponent,
-                         component::EdgeTriggeredComponent, 5, 5, 2, 3,
-                         "JKFLIPFLOP")
+IMPLEMENT_MEMORY(JKFlipFlop, MemoryType::JK, Trigger::EDGE, "JKFLIPFLOP")
 
 // DFlipFlop
-IMPLEMENT_CLOCKED_MEMORY(DFlipFlop, DMemoryComponent,
-                         component::EdgeTriggeredComponent, 4, 5, 2, 2,
-                         "DFLIPFLOP")
+IMPLEMENT_MEMORY(DFlipFlop, MemoryType::D, Trigger::EDGE, "DFLIPFLOP")
 
 // TFlipFlop
-IMPLEMENT_CLOCKED_MEMORY(TFlipFlop, TMemoryComponent,
-                         component::EdgeTriggeredComponent, 4, 5, 2, 2,
-                         "TFLIPFLOP")
+IMPLEMENT_MEMORY(TFlipFlop, MemoryType::T, Trigger::EDGE, "TFLIPFLOP")
 
 }
 }
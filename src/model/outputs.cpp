@@ -35,53 +35,20 @@ _5in_7SegmentDisplay::_5in_7SegmentDisplay() : Output(5, 8) {}
 
 void _5in_7SegmentDisplay::tick()
 {
-    _ticked = false;
+    unsigned int idx = 0;
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        State        x   = _inputs[i]->evaluate(_inputs_out[i]);
+        unsigned int bit = _5in_7segment_bit(i);
+        idx |= (x == State::ONE) << bit | (x == State::HiZ) << (bit + 5);
+    }
+    _evals = _5in_7segment_table[idx];
     Component::tick();
 }
 
 State _5in_7SegmentDisplay::_evaluate(unsigned int out)
 {
-    if (!_ticked)
-    {
-        for (size_t i = 0; i < 5; ++i)
-        {
-            _input_cache[i] = _inputs[i]->evaluate(_inputs_out[i]);
-        }
-    }
-
-    State(&x)[5] = _input_cache;
-    switch (out)
-    {
-    case 1:
-        return !((x[0] && x[1] && x[2]) || (x[0] && x[1] && !x[2] && !x[3]) ||
-                 (!x[0] && !x[1] && x[2] && !x[3]));
-    case 2:
-        return !((x[1] && x[2] && x[3]) || (!x[0] && x[1] && !x[2] && !x[3]) ||
-                 (!x[0] && !x[1] && !x[2] && x[3]) ||
-                 (x[0] && !x[1] && x[2] && !x[3]));
-    case 3:
-        return !((!x[0] && x[3]) || (!x[0] && x[1] && !x[2] && !x[3]) ||
-                 (x[0] && !x[1] && !x[2] && x[3]));
-    case 4:
-        return !((!x[0] && !x[1] && !x[2]) || (!x[0] && x[1] && x[2] && x[3]) ||
-                 (x[0] && x[1] && !x[2] && !x[3]));
-    case 5:
-        return !((!x[0] && !x[1] && x[2]) || (!x[0] && x[2] && x[3]) ||
-                 (!x[0] && !x[1] && !x[2] && x[3]) ||
-                 (x[0] && x[1] && !x[2] && x[3]));
-    case 6:
-        return !((!x[0] && !x[1] && !x[2] && x[3]) ||
-                 (!x[0] && x[1] && !x[2] && !x[3]) ||
-                 (x[0] && x[1] && !x[2] && x[3]) ||
-                 (x[0] && !x[1] && x[2] && x[3]));
-    case 7:
-        return !((x[1] && x[2] && !x[3]) || (x[0] && x[1] && x[2]) ||
-                 (x[0] && x[2] && x[3]) || (x[0] && x[1] && !x[3]) ||
-                 (!x[0] && x[1] && !x[2] && x[3]));
-    case 0:
-    default:
-        return x[4];
-    }
+    return static_cast<State>((_evals >> (2 * out)) & 3);
 }
 
 std::string _5in_7SegmentDisplay::ctype() const
@@ -94,20 +61,15 @@ _8in_7SegmentDisplay::_8in_7SegmentDisplay() : Output(8, 8) {}
 
 void _8in_7SegmentDisplay::tick()
 {
-    _ticked = false;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        _input_cache[i] = _inputs[i]->evaluate(_inputs_out[i]);
+    }
     Component::tick();
 }
 
 State _8in_7SegmentDisplay::_evaluate(unsigned int out)
 {
-    if (!_ticked)
-    {
-        for (size_t i = 0; i < 8; ++i)
-        {
-            _input_cache[i] = _inputs[i]->evaluate(_inputs_out[i]);
-        }
-    }
-
     return out < 8 ? _input_cache[7 - out] : _input_cache[0];
 }
 
@@ -0,0 +1,156 @@
+#include "model/profiler.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace profile
+{
+// LatencyHistogram
+LatencyHistogram::LatencyHistogram() : _buckets(N_BUCKETS, 0) {}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+    ++_buckets[_bucket_index(value)];
+    ++_count;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+    _sum += value;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _min   = std::numeric_limits<std::uint64_t>::max();
+    _max   = 0;
+    _sum   = 0;
+}
+
+std::uint64_t LatencyHistogram::count() const
+{
+    return _count;
+}
+
+std::uint64_t LatencyHistogram::min() const
+{
+    return _count > 0 ? _min : 0;
+}
+
+std::uint64_t LatencyHistogram::max() const
+{
+    return _max;
+}
+
+double LatencyHistogram::mean() const
+{
+    return _count > 0 ? _sum / _count : 0.0;
+}
+
+std::uint64_t LatencyHistogram::value_at_percentile(double percentile) const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    std::uint64_t target = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(percentile / 100 * _count + 0.5));
+    std::uint64_t total = 0;
+    for (unsigned int i = 0; i < N_BUCKETS; ++i)
+    {
+        total += _buckets[i];
+        if (total >= target)
+        {
+            return std::min(_bucket_max(i), _max);
+        }
+    }
+
+    return _max;
+}
+
+unsigned int LatencyHistogram::_bucket_index(std::uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return value;
+    }
+
+    // value >> shift is in [HALF_SUB_BUCKETS, SUB_BUCKETS)
+    unsigned int msb = 63;
+    while (!(value >> msb))
+    {
+        --msb;
+    }
+    unsigned int shift = msb - (SUB_BUCKET_BITS - 1);
+
+    return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS +
+           (value >> shift) - HALF_SUB_BUCKETS;
+}
+
+std::uint64_t LatencyHistogram::_bucket_max(unsigned int index)
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    unsigned int  shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    std::uint64_t top   = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS +
+                        HALF_SUB_BUCKETS;
+
+    return ((top + 1) << shift) - 1;
+}
+
+// Profile
+void Profile::reset()
+{
+    ticks = 0;
+    ctypes.fill({});
+    tick_latency.reset();
+}
+
+void Profile::write_json(std::ostream &stream) const
+{
+    stream << "{\n  \"ticks\": " << ticks << ",\n  \"tick_latency_ns\": {"
+           << " \"count\": " << tick_latency.count()
+           << ", \"min\": " << tick_latency.min()
+           << ", \"mean\": " << tick_latency.mean()
+           << ", \"p50\": " << tick_latency.value_at_percentile(50)
+           << ", \"p90\": " << tick_latency.value_at_percentile(90)
+           << ", \"p99\": " << tick_latency.value_at_percentile(99)
+           << ", \"p999\": " << tick_latency.value_at_percentile(99.9)
+           << ", \"max\": " << tick_latency.max() << " },\n  \"ctypes\": {";
+
+    bool first = true;
+    for (size_t i = 0; i < ctypes.size(); ++i)
+    {
+        const CtypeCounters &counters = ctypes[i];
+        if (counters.evaluations == 0)
+        {
+            continue;
+        }
+
+        stream << (first ? "" : ",") << "\n    \""
+               << (i == OTHER_CTYPE ? "OTHER" : model::ctypes[i])
+               << "\": { \"evaluations\": " << counters.evaluations
+               << ", \"total_ns\": " << counters.nanoseconds
+               << ", \"ns_per_evaluation\": "
+               << static_cast<double>(counters.nanoseconds) /
+                    counters.evaluations
+               << " }";
+        first = false;
+    }
+
+    stream << (first ? "}" : "\n  }") << "\n}\n";
+}
+
+std::string Profile::json() const
+{
+    std::ostringstream stream;
+    write_json(stream);
+    return stream.str();
+}
+}
+}
+}
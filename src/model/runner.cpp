@@ -0,0 +1,559 @@
+#include "model/runner.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace logicsim
+{
+namespace model
+{
+namespace sim
+{
+constexpr std::chrono::milliseconds Runner::PUBLISH_INTERVAL;
+constexpr std::chrono::milliseconds Runner::RATE_INTERVAL;
+
+Runner::Runner(circuit::Circuit &circuit, unsigned int frequency)
+  : _circuit(circuit)
+  , _events(EVENT_QUEUE_SIZE)
+  , _exclusive_waiting(false)
+  , _stop(false)
+  , _paused(true)
+  , _frequency(frequency)
+  , _steps(0)
+  , _idle(false)
+{
+    size_t n_values = 0;
+    _offsets.reserve(_circuit.size() + 1);
+    for (const auto &component : _circuit.components())
+    {
+        _slots[component] = n_values;
+        _offsets.push_back(n_values);
+        n_values += component->n_evals();
+    }
+    _offsets.push_back(n_values);
+    _unread_state.resize(_circuit.size());
+    _collect_changes(true);
+    _publish();
+
+    _thread = std::thread(&Runner::_run, this);
+}
+
+Runner::~Runner()
+{
+    _stop = true;
+    _notify();
+    _thread.join();
+}
+
+size_t Runner::slot(const component::Component &component) const
+{
+    return _slots.at(&component);
+}
+
+void Runner::set_frequency(unsigned int frequency)
+{
+    _frequency = frequency;
+    _notify();
+}
+
+unsigned int Runner::frequency() const
+{
+    return _frequency;
+}
+
+void Runner::pause()
+{
+    _paused = true;
+    _steps  = 0;
+    _notify();
+}
+
+void Runner::resume()
+{
+    _steps  = 0;
+    _paused = false;
+    _notify();
+}
+
+bool Runner::paused() const
+{
+    return _paused;
+}
+
+void Runner::step(std::uint64_t ticks)
+{
+    if (!_paused)
+    {
+        return;
+    }
+    _steps += ticks;
+    _notify();
+}
+
+std::uint64_t Runner::steps() const
+{
+    return _steps;
+}
+
+void Runner::post(const InputEvent &event)
+{
+    // the worker drains the queue at least once per tick, so it only fills up
+    // if the worker is stuck behind exclusive()
+    while (!_events.push(event))
+    {
+        std::this_thread::yield();
+    }
+    _notify();
+}
+
+void Runner::exclusive(const std::function<void(circuit::Circuit &)> &func)
+{
+    _exclusive_waiting = true;
+    {
+        std::lock_guard<std::mutex> lock(_circuit_mutex);
+        _exclusive_waiting = false;
+
+        // func may change the circuit, so it has to be ticked again
+        _wake_up();
+        func(_circuit);
+        // the worker publishes while holding the lock as well, so the owner
+        // can act as the writer here
+        _collect_changes(true);
+        _publish();
+    }
+    _notify();
+}
+
+void Runner::reset()
+{
+    exclusive(
+      [this](circuit::Circuit &circuit)
+      {
+          InputEvent event;
+          while (_events.pop(event)) {}
+          _pending.clear();
+          circuit.reset();
+      });
+}
+
+bool Runner::update_snapshot()
+{
+    if (!_updates.update())
+    {
+        return false;
+    }
+
+    const SnapshotUpdate &update = _updates.front();
+    _shown.tick                  = update.tick;
+    _shown.rate                  = update.rate;
+    _shown.idle                  = update.idle;
+    _shown.n_triggers            = update.n_triggers;
+    _shown.triggered             = update.triggered;
+
+    // every component counts as changed on the first update
+    bool first = _shown.values.size() != _offsets.back();
+    _shown.values.resize(_offsets.back());
+
+    _changed.clear();
+    size_t pos = 0;
+    for (size_t i : update.components)
+    {
+        bool changed = first;
+        for (size_t j = _offsets[i]; j < _offsets[i + 1]; ++j, ++pos)
+        {
+            if (update.values[pos] != _shown.values[j])
+            {
+                _shown.values[j] = update.values[pos];
+                changed          = true;
+            }
+        }
+        if (changed)
+        {
+            _changed.push_back(i);
+        }
+    }
+
+    return true;
+}
+
+const Snapshot &Runner::snapshot() const
+{
+    return _shown;
+}
+
+const std::vector<size_t> &Runner::changed() const
+{
+    return _changed;
+}
+
+void Runner::_notify()
+{
+    // lock so that the notification is not lost between the worker checking
+    // its condition and starting to wait
+    std::lock_guard<std::mutex> lock(_wake_mutex);
+    _wake.notify_one();
+}
+
+void Runner::_run()
+{
+    // running ticks are paced against an anchor, rather than tick by tick, so
+    // that any frequency is kept exactly, with ticks batched as needed
+    clock::time_point anchor       = clock::now();
+    std::uint64_t     anchor_ticks = 0;
+    unsigned int      frequency    = _frequency;
+    clock::time_point last_publish = anchor;
+    bool              dirty        = false;
+    bool              was_running  = false;
+    bool              was_active   = false;
+
+    while (!_stop)
+    {
+        while (_exclusive_waiting)
+        {
+            std::this_thread::yield();
+        }
+
+        std::uint64_t steps   = _steps;
+        bool          running = !_paused;
+        bool          active  = running || steps != 0;
+        if (running && (!was_running || frequency != _frequency))
+        {
+            anchor       = clock::now();
+            anchor_ticks = 0;
+            frequency    = _frequency;
+        }
+        if (active && (!was_active || running != was_running))
+        {
+            std::lock_guard<std::mutex> lock(_circuit_mutex);
+            _rate_time = clock::now();
+            _rate_tick = _circuit.total_ticks();
+        }
+        else if (!active && was_active)
+        {
+            // publish the paused state
+            dirty = true;
+        }
+        was_running = running;
+        was_active  = active;
+
+        if (_idle)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_wake_mutex);
+                _wake.wait(lock,
+                           [this]
+                           {
+                               return _stop || !_idle || _paused ||
+                                      _frequency != _idle_frequency ||
+                                      !_events.empty();
+                           });
+            }
+
+            // exclusive() may have woken up already
+            std::lock_guard<std::mutex> lock(_circuit_mutex);
+            _wake_up();
+            anchor       = clock::now();
+            anchor_ticks = 0;
+            _rate_time   = anchor;
+            _rate_tick   = _circuit.total_ticks();
+            continue;
+        }
+
+        if (!running && steps == 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_circuit_mutex);
+                if (!_events.empty() || dirty)
+                {
+                    _apply_events();
+                    _publish();
+                    dirty = false;
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(_wake_mutex);
+            _wake.wait(lock,
+                       [this]
+                       {
+                           return _stop || !_paused || _steps != 0 ||
+                                  !_events.empty();
+                       });
+            continue;
+        }
+
+        clock::time_point now   = clock::now();
+        std::uint64_t     limit = steps;
+
+        if (running && frequency == MAX_SPEED)
+        {
+            limit = std::numeric_limits<std::uint64_t>::max();
+        }
+        else if (running)
+        {
+            std::uint64_t due = _due_ticks(now - anchor, frequency);
+
+            // fall behind at most a second, e.g. after being suspended
+            if (due > anchor_ticks + frequency)
+            {
+                anchor       = now;
+                anchor_ticks = 0;
+                due          = 0;
+            }
+            if (due <= anchor_ticks)
+            {
+                clock::time_point next =
+                  anchor + std::chrono::nanoseconds((anchor_ticks + 1) *
+                                                    NS_PER_SECOND / frequency);
+                std::unique_lock<std::mutex> lock(_wake_mutex);
+                _wake.wait_until(lock,
+                                 next,
+                                 [this, frequency]
+                                 {
+                                     return _stop || _paused ||
+                                            frequency != _frequency ||
+                                            !_events.empty();
+                                 });
+                if (!_events.empty())
+                {
+                    lock.unlock();
+                    std::lock_guard<std::mutex> circuit_lock(_circuit_mutex);
+                    _apply_events();
+                }
+                continue;
+            }
+            limit = due - anchor_ticks;
+        }
+
+        // don't hold the circuit for more than a frame at a time
+        // the clock is read about every CHECK_EVALUATIONS evaluations
+        clock::time_point deadline  = now + 2 * PUBLISH_INTERVAL;
+        std::uint64_t     check     = std::max<std::uint64_t>(
+          1, CHECK_EVALUATIONS / (_circuit.size() + 1));
+        bool              triggered = false;
+        std::uint64_t     done      = 0;
+        {
+            std::lock_guard<std::mutex> lock(_circuit_mutex);
+            while (done < limit)
+            {
+                _apply_events();
+                _circuit.tick();
+                _collect_changes();
+                ++done;
+                if (!_circuit.triggered_watchpoints().empty())
+                {
+                    triggered = true;
+                    break;
+                }
+                if (done % check == 0 && clock::now() >= deadline)
+                {
+                    break;
+                }
+            }
+            dirty = true;
+
+            // events waiting for their tick keep the worker ticking
+            if (running && !triggered && _pending.empty() &&
+                _circuit.settled())
+            {
+                _idle           = true;
+                _idle_since     = clock::now();
+                _idle_frequency = frequency;
+            }
+
+            if (triggered)
+            {
+                _paused = true;
+                _steps  = 0;
+                ++_n_triggers;
+                _triggered = _circuit.triggered_watchpoints();
+            }
+            else if (!running)
+            {
+                // a settled circuit can't change during the remaining steps
+                if (done < steps && _pending.empty() && _circuit.settled())
+                {
+                    _circuit.skip(steps - done);
+                    done = steps;
+                }
+                // pause() may have cleared the steps meanwhile
+                while (steps != 0 &&
+                       !_steps.compare_exchange_weak(
+                         steps, steps - std::min(done, steps)))
+                {
+                }
+            }
+
+            now = clock::now();
+            if (triggered || _paused || _idle || (!running && _steps == 0) ||
+                now - last_publish >= PUBLISH_INTERVAL)
+            {
+                _publish();
+                last_publish = now;
+                dirty        = false;
+            }
+        }
+
+        if (running && frequency != MAX_SPEED)
+        {
+            anchor_ticks += done;
+            // move anchor forward every second, so that elapsed time can't
+            // overflow when multiplied by the frequency
+            if (anchor_ticks >= frequency)
+            {
+                anchor += std::chrono::seconds(1);
+                anchor_ticks -= frequency;
+            }
+        }
+    }
+}
+
+void Runner::_apply_events()
+{
+    InputEvent event;
+    while (_events.pop(event))
+    {
+        _pending.push_back(event);
+    }
+
+    std::uint64_t tick = _circuit.total_ticks();
+    for (auto it = _pending.begin(); it != _pending.end();)
+    {
+        if (it->tick > tick)
+        {
+            ++it;
+            continue;
+        }
+
+        switch (it->action)
+        {
+            case InputEvent::PRESS:
+                static_cast<input::Button *>(it->component)->press();
+                break;
+            case InputEvent::RELEASE:
+                static_cast<input::Button *>(it->component)->release();
+                break;
+            case InputEvent::SET:
+                it->component->set_params(std::to_string(it->value));
+                break;
+            case InputEvent::KEY:
+                static_cast<input::Keypad *>(it->component)->set_key(it->value);
+                break;
+        }
+        it = _pending.erase(it);
+    }
+}
+
+void Runner::_collect_changes(bool all)
+{
+    const auto   &components = _circuit.components();
+    std::uint64_t tick       = _circuit.total_ticks();
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        if (!all && !components[i]->changed())
+        {
+            continue;
+        }
+        Unread &state      = _unread_state[i];
+        state.output_tick  = tick + components[i]->delay();
+        state.published_in = 0;
+        if (!state.listed)
+        {
+            state.listed = true;
+            _unread.push_back(i);
+        }
+    }
+}
+
+void Runner::_publish()
+{
+    SnapshotUpdate &snapshot = _updates.back();
+    std::uint64_t   number   = ++_n_updates;
+
+    // the owner may have missed any update after the last one it is known to
+    // have taken, so each update carries the changes since then
+    const auto &components = _circuit.components();
+    snapshot.tick          = _circuit.total_ticks();
+    snapshot.components    = _unread;
+    snapshot.values.clear();
+    for (size_t i : _unread)
+    {
+        for (unsigned int j = 0; j < components[i]->n_evals(); ++j)
+        {
+            snapshot.values.push_back(components[i]->evaluate(j));
+        }
+        Unread &state = _unread_state[i];
+        if (state.published_in == 0 && snapshot.tick >= state.output_tick)
+        {
+            state.published_in = number;
+        }
+    }
+
+    snapshot.n_triggers = _n_triggers;
+    snapshot.triggered  = _triggered;
+    snapshot.idle       = _idle;
+
+    if ((_paused && _steps == 0) || _idle)
+    {
+        snapshot.rate = 0;
+    }
+    else
+    {
+        clock::time_point now = clock::now();
+        if (now - _rate_time >= RATE_INTERVAL)
+        {
+            std::chrono::duration<double> elapsed = now - _rate_time;
+            _rate = (snapshot.tick - _rate_tick) / elapsed.count();
+            _rate_time = now;
+            _rate_tick = snapshot.tick;
+        }
+        snapshot.rate = _rate;
+    }
+
+    if (!_updates.publish())
+    {
+        return;
+    }
+
+    // the owner took the previous update, so components whose outputs were
+    // final by then no longer need to be sent
+    _read_update = number - 1;
+    _unread.erase(std::remove_if(_unread.begin(),
+                                 _unread.end(),
+                                 [this](size_t i)
+                                 {
+                                     Unread &state = _unread_state[i];
+                                     state.listed =
+                                       state.published_in == 0 ||
+                                       state.published_in > _read_update;
+                                     return !state.listed;
+                                 }),
+                  _unread.end());
+}
+
+void Runner::_wake_up()
+{
+    if (!_idle)
+    {
+        return;
+    }
+    if (_idle_frequency != MAX_SPEED)
+    {
+        _circuit.skip(
+          _due_ticks(clock::now() - _idle_since, _idle_frequency));
+    }
+    _idle = false;
+}
+
+std::uint64_t Runner::_due_ticks(clock::duration elapsed,
+                                 unsigned int    frequency)
+{
+    std::uint64_t ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    // whole seconds are counted separately, so that long idle times can't
+    // overflow when multiplied by the frequency
+    return ns / NS_PER_SECOND * frequency +
+           ns % NS_PER_SECOND * frequency / NS_PER_SECOND;
+}
+}
+}
+}
@@ -0,0 +1,81 @@
+#include "model/watchpoint.hpp"
+
+namespace logicsim
+{
+namespace model
+{
+namespace watch
+{
+bool Watchpoint::fires(State prev, State curr) const
+{
+    switch (type)
+    {
+    case RISING_EDGE:
+        return prev == State::ZERO && curr == State::ONE;
+    case FALLING_EDGE:
+        return prev == State::ONE && curr == State::ZERO;
+    case ANY_EDGE:
+        return (prev == State::ZERO && curr == State::ONE) ||
+               (prev == State::ONE && curr == State::ZERO);
+    case LEVEL:
+        return curr == values[0];
+    case HIGH_IMPEDANCE:
+        return curr == State::HiZ;
+    default:
+        return false;
+    }
+}
+
+bool Watchpoint::matches() const
+{
+    for (size_t i = 0; i < probes.size(); ++i)
+    {
+        if (probes[i].component->evaluate(probes[i].out) != values[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Watchpoint rising_edge(component::Component &component, unsigned int out)
+{
+    return { RISING_EDGE, { { &component, out } }, {} };
+}
+
+Watchpoint falling_edge(component::Component &component, unsigned int out)
+{
+    return { FALLING_EDGE, { { &component, out } }, {} };
+}
+
+Watchpoint any_edge(component::Component &component, unsigned int out)
+{
+    return { ANY_EDGE, { { &component, out } }, {} };
+}
+
+Watchpoint level(component::Component &component, unsigned int out,
+                 State value)
+{
+    return { LEVEL, { { &component, out } }, { value } };
+}
+
+Watchpoint pattern(const std::vector<Probe> &probes,
+                   const std::vector<State> &values)
+{
+    if (probes.size() != values.size() || probes.empty())
+    {
+        throw std::invalid_argument(
+          "Pattern must have one value per probed output");
+    }
+
+    return { PATTERN, probes, values };
+}
+
+Watchpoint high_impedance(component::Component &component, unsigned int out)
+{
+    return { HIGH_IMPEDANCE, { { &component, out } }, {} };
+}
+}
+}
+}
@@ -0,0 +1,593 @@
+#include "tools/generators.hpp"
+
+namespace logicsim
+{
+namespace tools
+{
+namespace
+{
+// high for the given number of ticks once the simulation starts, then low
+// oscillator period is the largest allowed, so the pulse never repeats in
+// practice
+Pin reset_pulse(CircuitBuilder &builder, int col, int row, unsigned int ticks)
+{
+    unsigned int oscillator =
+      builder.add("OSCILLATOR",
+                  col,
+                  row,
+                  {},
+                  std::to_string(ticks) + ",2147483647,0");
+    return { builder.add("NOT", col, row + 1, { { oscillator, 0 } }), 0 };
+}
+
+struct FullAdder
+{
+    Pin sum, carry;
+};
+
+// full adder in a 2x3 block of cells, at (col, row)
+FullAdder full_adder(CircuitBuilder &builder, int col, int row, Pin a, Pin b,
+                     Pin carry)
+{
+    unsigned int p = builder.add("XOR", col, row, { a, b });
+    unsigned int g = builder.add("AND", col + 1, row, { a, b });
+    unsigned int s = builder.add("XOR", col, row + 1, { { p, 0 }, carry });
+    unsigned int t = builder.add("AND", col + 1, row + 1, { { p, 0 }, carry });
+    unsigned int c = builder.add("OR", col + 1, row + 2, { { g, 0 }, { t, 0 } });
+
+    return { { s, 0 }, { c, 0 } };
+}
+}
+
+// CircuitBuilder
+CircuitBuilder::CircuitBuilder(unsigned int frequency, std::uint64_t seed)
+  : _frequency(frequency)
+  , _seed(seed)
+{
+}
+
+unsigned int CircuitBuilder::add(const std::string &ctype, int col, int row,
+                                 const std::vector<Pin> &inputs,
+                                 const std::string      &params)
+{
+    _entries.push_back({ ctype,
+                         params,
+                         (_origin_col + col) * CELL_SIZE,
+                         (_origin_row + row) * CELL_SIZE,
+                         inputs });
+    _width  = std::max(_width, col + 1);
+    _height = std::max(_height, row + 1);
+
+    return _entries.size() - 1;
+}
+
+void CircuitBuilder::connect(unsigned int id, unsigned int input, Pin pin)
+{
+    if (id >= _entries.size() || input >= _entries[id].inputs.size())
+    {
+        throw std::invalid_argument("Invalid input to connect");
+    }
+    _entries[id].inputs[input] = pin;
+}
+
+void CircuitBuilder::set_origin(int col, int row)
+{
+    _origin_col = col;
+    _origin_row = row;
+    _width      = 0;
+    _height     = 0;
+}
+
+int CircuitBuilder::width() const
+{
+    return _width;
+}
+
+int CircuitBuilder::height() const
+{
+    return _height;
+}
+
+size_t CircuitBuilder::size() const
+{
+    return _entries.size();
+}
+
+void CircuitBuilder::write(std::ostream &stream) const
+{
+    stream << _frequency << ';' << _seed << "\n";
+
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        const Entry &entry = _entries[i];
+        stream << i << ';' << entry.ctype << ';' << entry.params << ';'
+               << entry.x << ',' << entry.y << ';';
+
+        for (size_t j = 0; j < entry.inputs.size(); ++j)
+        {
+            if (entry.inputs[j].id == NULL_PIN.id)
+            {
+                stream << "NULL";
+            }
+            else
+            {
+                stream << entry.inputs[j].id << ':' << entry.inputs[j].out;
+            }
+            if (j < entry.inputs.size() - 1)
+            {
+                stream << ',';
+            }
+        }
+
+        stream << "\n";
+    }
+}
+
+std::string CircuitBuilder::str() const
+{
+    std::ostringstream stream;
+    write(stream);
+    return stream.str();
+}
+
+// Generators
+Pin clock(CircuitBuilder &builder, int col, int row, unsigned int half_period)
+{
+    return { builder.add("OSCILLATOR",
+                         col,
+                         row,
+                         {},
+                         std::to_string(half_period) + ',' +
+                           std::to_string(2 * half_period) + ",0"),
+             0 };
+}
+
+Pin source(CircuitBuilder &builder, int col, int row, unsigned int i)
+{
+    return clock(builder, col, row, 1 + i % 16);
+}
+
+void ripple_carry_adder(CircuitBuilder &builder, unsigned int bits)
+{
+    Pin carry = { builder.add("CONSTANT", 0, 3, {}, "0"), 0 };
+
+    for (unsigned int i = 0; i < bits; ++i)
+    {
+        int       col = 2 * i + 1;
+        Pin       a   = source(builder, col, 0, 2 * i);
+        Pin       b   = source(builder, col + 1, 0, 2 * i + 1);
+        FullAdder fa  = full_adder(builder, col, 1, a, b, carry);
+
+        builder.add("OUTPUT", col, 4, { fa.sum });
+        carry = fa.carry;
+    }
+
+    builder.add("OUTPUT", 2 * bits + 1, 3, { carry });
+}
+
+void counter(CircuitBuilder &builder, unsigned int bits)
+{
+    Pin clk   = clock(builder, 0, 0, 10);
+    Pin one   = { builder.add("CONSTANT", 0, 1, {}, "1"), 0 };
+    Pin clear = reset_pulse(builder, 0, 2, 20);
+
+    for (unsigned int i = 0; i < bits; ++i)
+    {
+        unsigned int flip_flop =
+          builder.add("TFLIPFLOP", i + 1, 1, { NULL_PIN, one, clk, clear });
+        builder.add("OUTPUT", i + 1, 0, { { flip_flop, 0 } });
+        clk = { flip_flop, 1 };
+    }
+}
+
+void random_dag(CircuitBuilder &builder, unsigned int gates, unsigned int seed)
+{
+    static const std::pair<const char *, unsigned int> GATES[] = {
+        {  "AND", 2 },
+        {   "OR", 2 },
+        {  "XOR", 2 },
+        { "NAND", 2 },
+        {  "NOR", 2 },
+        { "XNOR", 2 },
+        {  "NOT", 1 },
+        { "BUFFER", 1 }
+    };
+
+    std::mt19937 rng(seed);
+
+    // gates are placed in columns of equal height, after a column of sources
+    unsigned int height = std::max(1u, static_cast<unsigned int>(
+                                         std::sqrt(static_cast<double>(gates))));
+    unsigned int n_sources = std::max(4u, gates / 16);
+
+    std::vector<Pin> nodes;
+    nodes.reserve(n_sources + gates);
+    for (unsigned int i = 0; i < n_sources; ++i)
+    {
+        nodes.push_back(source(builder, i / height, i % height, i));
+    }
+    int first_col = (n_sources + height - 1) / height;
+
+    // inputs are chosen among the last few nodes, so that the graph is deep
+    size_t window = 4 * height;
+
+    for (unsigned int i = 0; i < gates; ++i)
+    {
+        const auto &[ctype, n_inputs] = GATES[rng() % 8];
+
+        size_t           begin = nodes.size() > window ? nodes.size() - window
+                                                       : 0;
+        std::vector<Pin> inputs;
+        for (unsigned int j = 0; j < n_inputs; ++j)
+        {
+            inputs.push_back(nodes[begin + rng() % (nodes.size() - begin)]);
+        }
+
+        nodes.push_back({ builder.add(ctype,
+                                      first_col + i / height,
+                                      i % height,
+                                      inputs),
+                          0 });
+    }
+
+    int last_col = first_col + (gates + height - 1) / height;
+    for (unsigned int i = 0; i < std::min(gates, 8u); ++i)
+    {
+        builder.add("OUTPUT", last_col, i, { nodes[nodes.size() - 1 - i] });
+    }
+}
+
+void connector_chain(CircuitBuilder &builder, unsigned int length)
+{
+    // chain is laid out in rows of ROW_LENGTH, alternating direction
+    const unsigned int ROW_LENGTH = 100;
+
+    Pin pin = clock(builder, 0, 0, 1);
+
+    unsigned int i = 0;
+    for (; i < length; ++i)
+    {
+        unsigned int row = i / ROW_LENGTH, col = i % ROW_LENGTH;
+        if (row % 2 == 1)
+        {
+            col = ROW_LENGTH - 1 - col;
+        }
+        pin = { builder.add("CONNECTOR", col + 1, row, { pin }), 0 };
+    }
+
+    builder.add("OUTPUT", ROW_LENGTH + 1, i / ROW_LENGTH, { pin });
+}
+
+void mux_tree(CircuitBuilder &builder, unsigned int levels)
+{
+    Pin enable = { builder.add("CONSTANT", 0, 0, {}, "0"), 0 };
+
+    // select inputs of each level, S0 being the most significant bit
+    std::vector<std::vector<Pin>> selects(levels);
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            selects[level].push_back(
+              source(builder, 1 + level, i, 3 * level + i + 4));
+        }
+    }
+
+    size_t           n_leaves = std::pow(8, levels);
+    std::vector<Pin> pins;
+    pins.reserve(n_leaves);
+    for (size_t i = 0; i < n_leaves; ++i)
+    {
+        pins.push_back(source(builder, 0, 4 + i, i));
+    }
+
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        size_t           span = std::pow(8, level + 1);
+        std::vector<Pin> next;
+        next.reserve(pins.size() / 8);
+
+        for (size_t i = 0; i < pins.size() / 8; ++i)
+        {
+            std::vector<Pin> inputs = { enable };
+            inputs.insert(inputs.end(), pins.begin() + 8 * i,
+                          pins.begin() + 8 * i + 8);
+            inputs.insert(inputs.end(), selects[level].begin(),
+                          selects[level].end());
+            next.push_back({ builder.add("MUX-3",
+                                         1 + level,
+                                         4 + i * span + span / 2,
+                                         inputs),
+                             0 });
+        }
+        pins = std::move(next);
+    }
+
+    builder.add("OUTPUT", 1 + levels, 4 + n_leaves / 2, pins);
+}
+
+void decoder_tree(CircuitBuilder &builder, unsigned int levels)
+{
+    if (levels == 0)
+    {
+        return;
+    }
+
+    // address inputs of each level, B0 being the least significant bit
+    std::vector<std::vector<Pin>> addresses(levels);
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            addresses[level].push_back(
+              source(builder, 2 * level, i, 3 * level + i));
+        }
+    }
+
+    // enable inputs are active low; decoder outputs are inverted to enable
+    // the next level
+    std::vector<Pin> enables = {
+        { builder.add("CONSTANT", 0, 3, {}, "0"), 0 }
+    };
+
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        size_t           span = std::pow(8, levels - 1 - level);
+        std::vector<Pin> next;
+        next.reserve(8 * enables.size());
+
+        for (size_t i = 0; i < enables.size(); ++i)
+        {
+            std::vector<Pin> inputs = addresses[level];
+            inputs.push_back(enables[i]);
+            int          row = 4 + i * 8 * span;
+            unsigned int decoder =
+              builder.add("DEC-3", 2 * level, row + 4 * span, inputs);
+
+            if (level == levels - 1)
+            {
+                continue;
+            }
+            for (unsigned int out = 0; out < 8; ++out)
+            {
+                next.push_back({ builder.add("NOT",
+                                             2 * level + 1,
+                                             row + out * span + span / 2,
+                                             { { decoder, out } }),
+                                 0 });
+            }
+        }
+        enables = std::move(next);
+    }
+}
+void array_multiplier(CircuitBuilder &builder, unsigned int bits)
+{
+    if (bits == 0)
+    {
+        return;
+    }
+
+    // column 2k holds bit k of the product, row block 4j adds row j of
+    // partial products
+    Pin zero = { builder.add("CONSTANT", 4 * bits, 0, {}, "0"), 0 };
+
+    std::vector<Pin> a, b;
+    for (unsigned int i = 0; i < bits; ++i)
+    {
+        a.push_back(source(builder, 2 * i, 0, i));
+        b.push_back(source(builder, 4 * bits, 4 * i + 1, bits + i));
+    }
+
+    auto partial_product = [&builder, &a, &b](unsigned int i, unsigned int j)
+    {
+        return Pin { builder.add("AND", 2 * (i + j), 4 * j + 1, { a[i], b[j] }),
+                     0 };
+    };
+
+    std::vector<Pin> product(2 * bits, zero);
+    for (unsigned int i = 0; i < bits; ++i)
+    {
+        product[i] = partial_product(i, 0);
+    }
+
+    for (unsigned int j = 1; j < bits; ++j)
+    {
+        Pin carry = zero;
+        for (unsigned int i = 0; i < bits; ++i)
+        {
+            Pin       pp = partial_product(i, j);
+            FullAdder fa = full_adder(
+              builder, 2 * (i + j), 4 * j + 2, product[i + j], pp, carry);
+            product[i + j] = fa.sum;
+            carry          = fa.carry;
+        }
+        product[j + bits] = carry;
+    }
+
+    for (unsigned int k = 0; k < 2 * bits; ++k)
+    {
+        builder.add("OUTPUT", 2 * k, 4 * bits + 1, { product[k] });
+    }
+}
+
+void lfsr(CircuitBuilder &builder, unsigned int bits)
+{
+    // taps giving maximal length sequences, from Xilinx XAPP052
+    static const std::vector<std::vector<unsigned int>> TAPS = {
+        {},
+        {},
+        { 2, 1 },
+        { 3, 2 },
+        { 4, 3 },
+        { 5, 3 },
+        { 6, 5 },
+        { 7, 6 },
+        { 8, 6, 5, 4 },
+        { 9, 5 },
+        { 10, 7 },
+        { 11, 9 },
+        { 12, 6, 4, 1 },
+        { 13, 4, 3, 1 },
+        { 14, 5, 3, 1 },
+        { 15, 14 },
+        { 16, 15, 13, 4 },
+        { 17, 14 },
+        { 18, 11 },
+        { 19, 6, 2, 1 },
+        { 20, 17 },
+        { 21, 19 },
+        { 22, 21 },
+        { 23, 18 },
+        { 24, 23, 22, 17 },
+        { 25, 22 },
+        { 26, 6, 2, 1 },
+        { 27, 5, 2, 1 },
+        { 28, 25 },
+        { 29, 27 },
+        { 30, 6, 4, 1 },
+        { 31, 28 },
+        { 32, 22, 2, 1 }
+    };
+
+    if (bits < 2)
+    {
+        throw std::invalid_argument("LFSR needs at least 2 bits");
+    }
+
+    std::vector<unsigned int> taps = bits < TAPS.size()
+                                       ? TAPS[bits]
+                                       : std::vector<unsigned int> { bits,
+                                                                     bits - 1 };
+
+    Pin clk   = clock(builder, 0, 0, 10);
+    Pin pulse = reset_pulse(builder, 0, 2, 20);
+
+    // first flip-flop is preset and all others cleared, so that the register
+    // does not start from the all-zero state, which it would never leave
+    std::vector<unsigned int> flip_flops;
+    for (unsigned int i = 0; i < bits; ++i)
+    {
+        flip_flops.push_back(builder.add(
+          "DFLIPFLOP",
+          i + 1,
+          1,
+          { i == 0 ? pulse : NULL_PIN,
+            i == 0 ? NULL_PIN : Pin { flip_flops.back(), 0 },
+            clk,
+            i == 0 ? NULL_PIN : pulse }));
+        builder.add("OUTPUT", i + 1, 0, { { flip_flops.back(), 0 } });
+    }
+
+    Pin feedback = { flip_flops[taps[0] - 1], 0 };
+    for (size_t t = 1; t < taps.size(); ++t)
+    {
+        feedback = { builder.add("XOR",
+                                 taps[t],
+                                 2 + t,
+                                 { feedback, { flip_flops[taps[t] - 1], 0 } }),
+                     0 };
+    }
+    builder.connect(flip_flops[0], 1, feedback);
+}
+
+void register_file(CircuitBuilder &builder, unsigned int address_bits,
+                   unsigned int width)
+{
+    if (address_bits < 1 || address_bits > 3)
+    {
+        throw std::invalid_argument(
+          "Register file address bits must be between 1 and 3");
+    }
+
+    unsigned int words     = 1 << address_bits;
+    std::string  bits      = std::to_string(address_bits);
+    int          right_col = 2 * width;
+
+    // enable inputs of decoders and multiplexers are active low
+    Pin enable = { builder.add("CONSTANT", right_col, 0, {}, "0"), 0 };
+    Pin clk    = clock(builder, right_col + 1, 0, 10);
+
+    // write address, B0 being the least significant bit, and read address,
+    // S0 being the most significant bit
+    std::vector<Pin> write_address, read_address;
+    for (unsigned int i = 0; i < address_bits; ++i)
+    {
+        write_address.push_back(source(builder, right_col + 1, 1 + i, i + 5));
+        read_address.insert(
+          read_address.begin(),
+          source(builder, right_col + 1, words + 1 + i, i + 9));
+    }
+
+    std::vector<Pin> decoder_inputs = write_address;
+    decoder_inputs.push_back(enable);
+    unsigned int decoder =
+      builder.add("DEC-" + bits, right_col, 1, decoder_inputs);
+
+    std::vector<Pin> data;
+    for (unsigned int b = 0; b < width; ++b)
+    {
+        data.push_back(source(builder, 2 * b, 0, b));
+    }
+
+    // each bit of a register holds its value, unless the register is selected
+    // by the write address
+    std::vector<std::vector<Pin>> registers(words);
+    for (unsigned int r = 0; r < words; ++r)
+    {
+        for (unsigned int b = 0; b < width; ++b)
+        {
+            unsigned int select = builder.add(
+              "MUX-1",
+              2 * b,
+              1 + r,
+              { enable, NULL_PIN, data[b], { decoder, r } });
+            unsigned int flip_flop = builder.add(
+              "DFLIPFLOP",
+              2 * b + 1,
+              1 + r,
+              { NULL_PIN, { select, 0 }, clk, NULL_PIN });
+            builder.connect(select, 1, { flip_flop, 0 });
+            registers[r].push_back({ flip_flop, 0 });
+        }
+    }
+
+    for (unsigned int b = 0; b < width; ++b)
+    {
+        std::vector<Pin> inputs = { enable };
+        for (unsigned int r = 0; r < words; ++r)
+        {
+            inputs.push_back(registers[r][b]);
+        }
+        inputs.insert(inputs.end(), read_address.begin(), read_address.end());
+
+        unsigned int read = builder.add("MUX-" + bits, 2 * b, 1 + words, inputs);
+        builder.add("OUTPUT", 2 * b, 2 + words, { { read, 0 } });
+    }
+}
+
+void tile(CircuitBuilder &builder, unsigned int count,
+          const std::function<void(CircuitBuilder &)> &generate)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    builder.set_origin(0, 0);
+    generate(builder);
+
+    // instances are separated by an empty cell
+    int width  = builder.width() + 1;
+    int height = builder.height() + 1;
+
+    unsigned int columns = std::max(
+      1.0, std::round(std::sqrt(static_cast<double>(count) * height / width)));
+
+    for (unsigned int i = 1; i < count; ++i)
+    {
+        builder.set_origin((i % columns) * width, (i / columns) * height);
+        generate(builder);
+    }
+}
+}
+}
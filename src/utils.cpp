@@ -37,6 +37,39 @@ void StringSplitter::reset(const std::string &str, char delimiter)
     _done      = false;
 }
 
+StringViewSplitter::StringViewSplitter() {}
+
+StringViewSplitter::StringViewSplitter(std::string_view str, char delimiter)
+  : _str(str)
+  , _delimiter(delimiter)
+{
+}
+
+bool StringViewSplitter::has_next() const
+{
+    return !_done;
+}
+
+std::string_view StringViewSplitter::next()
+{
+    size_t split_pos = _str.find(_delimiter, _pos);
+    if (split_pos == std::string_view::npos)
+    {
+        _done = true;
+    }
+    size_t prev = _pos;
+    _pos        = split_pos + 1;
+    return _str.substr(prev, split_pos - prev);
+}
+
+void StringViewSplitter::reset(std::string_view str, char delimiter)
+{
+    _str       = str;
+    _delimiter = delimiter;
+    _pos       = 0;
+    _done      = false;
+}
+
 size_t get_int_from_bools(std::vector<bool> bools)
 {
     size_t result = 0;
@@ -48,7 +81,7 @@ size_t get_int_from_bools(std::vector<bool> bools)
     return result;
 }
 
-bool is_positive_int(std::string str)
+bool is_positive_int(std::string_view str)
 {
     if (str.empty())
     {
@@ -65,5 +98,63 @@ bool is_positive_int(std::string str)
 
     return true;
 }
+
+unsigned int thread_count(unsigned int n_threads)
+{
+    if (n_threads == 0)
+    {
+        n_threads = std::thread::hardware_concurrency();
+    }
+    return std::max(n_threads, 1u);
+}
+
+void parallel_for(size_t n, unsigned int n_threads,
+                  const std::function<void(size_t, size_t)> &func)
+{
+    size_t n_ranges = std::min<size_t>(thread_count(n_threads), n);
+    if (n_ranges <= 1)
+    {
+        if (n > 0)
+        {
+            func(0, n);
+        }
+        return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(n_ranges);
+    std::vector<std::thread>        threads;
+    threads.reserve(n_ranges - 1);
+
+    auto run_range = [n, n_ranges, &func, &exceptions](size_t range)
+    {
+        try
+        {
+            func(range * n / n_ranges, (range + 1) * n / n_ranges);
+        }
+        catch (...)
+        {
+            exceptions[range] = std::current_exception();
+        }
+    };
+
+    for (size_t range = 1; range < n_ranges; ++range)
+    {
+        threads.emplace_back(run_range, range);
+    }
+    run_range(0);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &exception : exceptions)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
 }
 }
@@ -0,0 +1,406 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model/circuit.hpp"
+#include "model/circuit_file.hpp"
+#include "tools/generators.hpp"
+
+#include "utils.hpp"
+
+/* Simulation benchmark
+ * Generates synthetic circuits, loads them and simulates them for a number of
+ * ticks, reporting for each:
+ *  load time (parsing and creating components)
+ *  memory allocated per component once loaded
+ *  ticks per second
+ *  nanoseconds per component evaluation (one component for one tick)
+ * Results can be printed as a table, JSON or CSV, for tracking over time
+ */
+
+// Allocation tracking, used to measure memory per component
+namespace
+{
+std::atomic<size_t> allocated_bytes(0);
+
+// allocations are prefixed with their size, padded to keep them aligned
+constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+}
+
+void *operator new(size_t size)
+{
+    void *block = std::malloc(size + ALLOCATION_HEADER);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(block) = size;
+    allocated_bytes += size;
+    return static_cast<char *>(block) + ALLOCATION_HEADER;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    void *block = static_cast<char *>(ptr) - ALLOCATION_HEADER;
+    allocated_bytes -= *static_cast<size_t *>(block);
+    std::free(block);
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+using namespace logicsim;
+
+const char *USAGE =
+  "Usage: logicsim-bench [options]\n"
+  "Options:\n"
+  "  -n, --ticks N         ticks to simulate per benchmark (default: 1000)\n"
+  "  -s, --scale N         multiply circuit sizes by N (default: 1)\n"
+  "  -b, --bench NAME      only run benchmarks whose name contains NAME; may\n"
+  "                        be repeated\n"
+  "  -f, --format FORMAT   output format: text, json or csv (default: text)\n"
+  "  -l, --list            list benchmarks and exit\n"
+  "  -h, --help            show this message\n";
+
+struct Options
+{
+    unsigned int             ticks  = 1000;
+    unsigned int             scale  = 1;
+    std::string              format = "text";
+    std::vector<std::string> filters;
+    bool                     list = false;
+};
+
+struct Benchmark
+{
+    std::string name;
+    // generates the circuit, for the given scale
+    std::function<void(tools::CircuitBuilder &, unsigned int)> generate;
+};
+
+struct Result
+{
+    std::string name;
+    size_t      components;
+    double      load_seconds;
+    double      bytes_per_component;
+    unsigned    ticks;
+    double      tick_seconds;
+
+    double ticks_per_second() const
+    {
+        return tick_seconds > 0 ? ticks / tick_seconds : 0.0;
+    }
+
+    double ns_per_evaluation() const
+    {
+        return ticks > 0 && components > 0
+                 ? 1e9 * tick_seconds / (static_cast<double>(ticks) * components)
+                 : 0.0;
+    }
+};
+
+const std::vector<Benchmark> BENCHMARKS = {
+    { "adder",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      { tools::ripple_carry_adder(builder, 1024 * scale); } },
+    { "counter",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      { tools::counter(builder, 4096 * scale); } },
+    { "random_dag",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      { tools::random_dag(builder, 8192 * scale, 1); } },
+    { "connector_chain",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      { tools::connector_chain(builder, 8192 * scale); } },
+    { "mux_tree",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      {
+          for (unsigned int i = 0; i < scale; ++i)
+          {
+              builder.set_origin(0, i * (4 + 4096));
+              tools::mux_tree(builder, 4);
+          }
+      } },
+    { "decoder_tree",
+      [](tools::CircuitBuilder &builder, unsigned int scale)
+      {
+          for (unsigned int i = 0; i < scale; ++i)
+          {
+              builder.set_origin(0, i * (4 + 4096));
+              tools::decoder_tree(builder, 4);
+          }
+      } }
+};
+
+unsigned int parse_uint(const std::string &str, const std::string &what)
+{
+    if (!utils::is_positive_int(str))
+    {
+        throw std::invalid_argument("invalid " + what + ": " + str);
+    }
+
+    try
+    {
+        return std::stoul(str);
+    }
+    catch (const std::out_of_range &)
+    {
+        throw std::invalid_argument("invalid " + what + ": " + str);
+    }
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (arg == "-l" || arg == "--list")
+        {
+            options.list = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        std::string value = argv[++i];
+
+        if (arg == "-n" || arg == "--ticks")
+        {
+            options.ticks = parse_uint(value, "tick count");
+        }
+        else if (arg == "-s" || arg == "--scale")
+        {
+            options.scale = parse_uint(value, "scale");
+            if (options.scale == 0)
+            {
+                throw std::invalid_argument("invalid scale: " + value);
+            }
+        }
+        else if (arg == "-b" || arg == "--bench")
+        {
+            options.filters.push_back(value);
+        }
+        else if (arg == "-f" || arg == "--format")
+        {
+            if (value != "text" && value != "json" && value != "csv")
+            {
+                throw std::invalid_argument("invalid format: " + value);
+            }
+            options.format = value;
+        }
+        else
+        {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+
+    return options;
+}
+
+bool selected(const Benchmark &benchmark, const Options &options)
+{
+    if (options.filters.empty())
+    {
+        return true;
+    }
+    for (const auto &filter : options.filters)
+    {
+        if (benchmark.name.find(filter) != std::string::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Result run_benchmark(const Benchmark &benchmark, const Options &options)
+{
+    typedef std::chrono::steady_clock clock;
+
+    tools::CircuitBuilder builder;
+    benchmark.generate(builder, options.scale);
+    std::string contents = builder.str();
+
+    Result result;
+    result.name  = benchmark.name;
+    result.ticks = options.ticks;
+
+    model::circuit::Circuit circuit;
+    size_t                  bytes_before = allocated_bytes;
+
+    clock::time_point start = clock::now();
+    {
+        model::file::CircuitFile circuit_file =
+          model::file::parse(std::move(contents));
+        result.components = model::file::load(circuit_file, circuit).size();
+    }
+    result.load_seconds =
+      std::chrono::duration<double>(clock::now() - start).count();
+
+    // circuit file is freed by now, so only the circuit is counted
+    result.bytes_per_component =
+      static_cast<double>(allocated_bytes - bytes_before) / result.components;
+
+    start = clock::now();
+    for (unsigned int i = 0; i < options.ticks; ++i)
+    {
+        circuit.tick();
+    }
+    result.tick_seconds =
+      std::chrono::duration<double>(clock::now() - start).count();
+
+    return result;
+}
+
+void print_text(const std::vector<Result> &results)
+{
+    std::cout << std::left << std::setw(18) << "benchmark" << std::right
+              << std::setw(12) << "components" << std::setw(12) << "load ms"
+              << std::setw(12) << "B/comp" << std::setw(14) << "ticks/s"
+              << std::setw(12) << "ns/eval" << "\n";
+
+    std::cout << std::fixed;
+    for (const auto &result : results)
+    {
+        std::cout << std::left << std::setw(18) << result.name << std::right
+                  << std::setw(12) << result.components << std::setw(12)
+                  << std::setprecision(1) << 1e3 * result.load_seconds
+                  << std::setw(12) << std::setprecision(0)
+                  << result.bytes_per_component << std::setw(14)
+                  << std::setprecision(1) << result.ticks_per_second()
+                  << std::setw(12) << std::setprecision(2)
+                  << result.ns_per_evaluation() << "\n";
+    }
+}
+
+void print_json(const std::vector<Result> &results, const Options &options)
+{
+    std::cout << "{\n  \"ticks\": " << options.ticks
+              << ",\n  \"scale\": " << options.scale
+              << ",\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        std::cout << (i > 0 ? "," : "") << "\n    { \"name\": \""
+                  << result.name << "\", \"components\": " << result.components
+                  << ", \"load_seconds\": " << result.load_seconds
+                  << ", \"bytes_per_component\": "
+                  << result.bytes_per_component
+                  << ", \"ticks\": " << result.ticks
+                  << ", \"tick_seconds\": " << result.tick_seconds
+                  << ", \"ticks_per_second\": " << result.ticks_per_second()
+                  << ", \"ns_per_evaluation\": " << result.ns_per_evaluation()
+                  << " }";
+    }
+
+    std::cout << "\n  ]\n}\n";
+}
+
+void print_csv(const std::vector<Result> &results)
+{
+    std::cout << "name,components,load_seconds,bytes_per_component,ticks,"
+                 "tick_seconds,ticks_per_second,ns_per_evaluation\n";
+
+    for (const auto &result : results)
+    {
+        std::cout << result.name << ',' << result.components << ','
+                  << result.load_seconds << ',' << result.bytes_per_component
+                  << ',' << result.ticks << ',' << result.tick_seconds << ','
+                  << result.ticks_per_second() << ','
+                  << result.ns_per_evaluation() << "\n";
+    }
+}
+
+int run(const Options &options)
+{
+    if (options.list)
+    {
+        for (const auto &benchmark : BENCHMARKS)
+        {
+            std::cout << benchmark.name << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (const auto &benchmark : BENCHMARKS)
+    {
+        if (selected(benchmark, options))
+        {
+            results.push_back(run_benchmark(benchmark, options));
+        }
+    }
+
+    if (options.format == "json")
+    {
+        print_json(results, options);
+    }
+    else if (options.format == "csv")
+    {
+        print_csv(results);
+    }
+    else
+    {
+        print_text(results);
+    }
+
+    return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        return run(parse_options(argc, argv));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "logicsim-bench: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,667 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model/binary_file.hpp"
+#include "model/circuit.hpp"
+#include "model/circuit_file.hpp"
+#include "model/component.hpp"
+#include "model/inputs.hpp"
+#include "model/watchpoint.hpp"
+
+#include "utils.hpp"
+
+/* Headless simulator
+ * Loads a circuit file, optionally drives its inputs from a stimulus file,
+ * runs it for a number of ticks (or until a condition is met) and prints the
+ * values of outputs, along with throughput statistics
+ *
+ * Stimulus files contain one event per line, as:
+ *  TICK ID ACTION [VALUE]
+ * where the event is applied once TICK ticks have been simulated, ID is the id
+ * of a component in the circuit file and ACTION is one of:
+ *  press, release (BUTTON)
+ *  toggle (SWITCH)
+ *  set 0|1 (SWITCH, CONSTANT)
+ *  key 0-15 (KEYPAD)
+ * Empty lines and lines starting with # are ignored
+ */
+
+namespace
+{
+using namespace logicsim;
+using model::component::Component;
+
+const char *USAGE =
+  "Usage: logicsim-cli [options] FILE\n"
+  "Options:\n"
+  "  -n, --ticks N         ticks to simulate (default: circuit frequency)\n"
+  "  -u, --until COND      stop once COND is met; may be repeated, where\n"
+  "                        COND is rise|fall|edge|high|low|hiz:ID[:OUT] or\n"
+  "                        eq:ID[:OUT]=0|1|Z[,ID[:OUT]=0|1|Z...]\n"
+  "  -s, --stimulus FILE   drive inputs from stimulus file\n"
+  "  -p, --print ID[:OUT]  comma separated outputs to print (default: all\n"
+  "                        output components)\n"
+  "  -e, --every N         also print outputs every N ticks\n"
+  "  -j, --threads N       threads used to load large circuits (default: one\n"
+  "                        per hardware thread)\n"
+  "  -P, --profile FILE    write evaluations and time per component type, and\n"
+  "                        tick latencies, to FILE as JSON\n"
+  "  -q, --quiet           do not print statistics\n"
+  "  -c, --convert FILE    convert circuit to FILE and exit; FILE is written\n"
+  "                        in binary format if it ends in .lsb, text otherwise\n"
+  "  -h, --help            show this message\n"
+  "Exit status is 0 on success, 1 on error and 2 if no --until condition was\n"
+  "met within the simulated ticks\n";
+
+struct Options
+{
+    std::string              filepath;
+    std::string              stimulus_filepath;
+    std::string              convert_filepath;
+    std::string              profile_filepath;
+    std::uint64_t            ticks       = 0;
+    bool                     ticks_given = false;
+    std::vector<std::string> conditions;
+    std::string              print;
+    std::uint64_t            every     = 0;
+    unsigned int             n_threads = 0;
+    bool                     quiet     = false;
+};
+
+struct StimulusEvent
+{
+    std::uint64_t tick;
+    Component    *component;
+    std::string   action;
+    unsigned int  value;
+    size_t        line;
+};
+
+typedef std::unordered_map<std::string, Component *> ComponentMap;
+
+// circuits count ticks in 64 bits
+constexpr std::uint64_t MAX_TICKS = std::numeric_limits<std::uint64_t>::max();
+
+// parses a non-negative integer no greater than max
+std::uint64_t parse_uint(
+  const std::string &str, const std::string &what,
+  std::uint64_t max = std::numeric_limits<unsigned int>::max())
+{
+    if (!utils::is_positive_int(str))
+    {
+        throw std::invalid_argument("invalid " + what + ": " + str);
+    }
+
+    try
+    {
+        std::uint64_t value = std::stoull(str);
+        if (value <= max)
+        {
+            return value;
+        }
+    }
+    catch (const std::out_of_range &)
+    {
+    }
+    throw std::invalid_argument("invalid " + what + ": " + str);
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (arg == "-q" || arg == "--quiet")
+        {
+            options.quiet = true;
+            continue;
+        }
+        if (arg.empty() || arg[0] != '-')
+        {
+            if (!options.filepath.empty())
+            {
+                throw std::invalid_argument("more than one circuit file given");
+            }
+            options.filepath = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        std::string value = argv[++i];
+
+        if (arg == "-n" || arg == "--ticks")
+        {
+            options.ticks       = parse_uint(value, "tick count", MAX_TICKS);
+            options.ticks_given = true;
+        }
+        else if (arg == "-u" || arg == "--until")
+        {
+            options.conditions.push_back(value);
+        }
+        else if (arg == "-s" || arg == "--stimulus")
+        {
+            options.stimulus_filepath = value;
+        }
+        else if (arg == "-p" || arg == "--print")
+        {
+            options.print = value;
+        }
+        else if (arg == "-e" || arg == "--every")
+        {
+            options.every = parse_uint(value, "print interval", MAX_TICKS);
+        }
+        else if (arg == "-j" || arg == "--threads")
+        {
+            options.n_threads = parse_uint(value, "thread count");
+        }
+        else if (arg == "-P" || arg == "--profile")
+        {
+            options.profile_filepath = value;
+        }
+        else if (arg == "-c" || arg == "--convert")
+        {
+            options.convert_filepath = value;
+        }
+        else
+        {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+
+    if (options.filepath.empty())
+    {
+        throw std::invalid_argument("no circuit file given");
+    }
+
+    return options;
+}
+
+Component *find_component(const ComponentMap &components, const std::string &id)
+{
+    auto it = components.find(id);
+    if (it == components.end())
+    {
+        throw std::invalid_argument("no component with id " + id);
+    }
+
+    return it->second;
+}
+
+// parses ID[:OUT]
+model::watch::Probe parse_probe(const ComponentMap &components,
+                                const std::string  &str)
+{
+    utils::StringSplitter splitter(str, ':');
+    Component   *component = find_component(components, splitter.next());
+    unsigned int out       = 0;
+    if (splitter.has_next())
+    {
+        out = parse_uint(splitter.next(), "output index");
+    }
+    if (splitter.has_next() || out >= component->n_evals())
+    {
+        throw std::invalid_argument("invalid output " + str);
+    }
+
+    return { component, out };
+}
+
+model::State parse_state(const std::string &str)
+{
+    if (str == "0")
+    {
+        return model::State::ZERO;
+    }
+    if (str == "1")
+    {
+        return model::State::ONE;
+    }
+    if (str == "Z" || str == "z")
+    {
+        return model::State::HiZ;
+    }
+
+    throw std::invalid_argument("invalid state " + str);
+}
+
+model::watch::Watchpoint parse_condition(const ComponentMap &components,
+                                         const std::string  &condition)
+{
+    size_t kind_end = condition.find(':');
+    if (kind_end == std::string::npos)
+    {
+        throw std::invalid_argument("invalid condition " + condition);
+    }
+    std::string kind = condition.substr(0, kind_end);
+    std::string spec = condition.substr(kind_end + 1);
+
+    if (kind == "eq")
+    {
+        std::vector<model::watch::Probe> probes;
+        std::vector<model::State>        values;
+
+        utils::StringSplitter splitter(spec, ',');
+        while (splitter.has_next())
+        {
+            std::string term   = splitter.next();
+            size_t      eq_pos = term.find('=');
+            if (eq_pos == std::string::npos)
+            {
+                throw std::invalid_argument("invalid condition " + condition);
+            }
+            probes.push_back(parse_probe(components, term.substr(0, eq_pos)));
+            values.push_back(parse_state(term.substr(eq_pos + 1)));
+        }
+
+        return model::watch::pattern(probes, values);
+    }
+
+    model::watch::Probe probe = parse_probe(components, spec);
+    if (kind == "rise")
+    {
+        return model::watch::rising_edge(*probe.component, probe.out);
+    }
+    if (kind == "fall")
+    {
+        return model::watch::falling_edge(*probe.component, probe.out);
+    }
+    if (kind == "edge")
+    {
+        return model::watch::any_edge(*probe.component, probe.out);
+    }
+    if (kind == "high")
+    {
+        return model::watch::level(*probe.component,
+                                   probe.out,
+                                   model::State::ONE);
+    }
+    if (kind == "low")
+    {
+        return model::watch::level(*probe.component,
+                                   probe.out,
+                                   model::State::ZERO);
+    }
+    if (kind == "hiz")
+    {
+        return model::watch::high_impedance(*probe.component, probe.out);
+    }
+
+    throw std::invalid_argument("invalid condition " + condition);
+}
+
+std::vector<StimulusEvent> read_stimulus(const std::string  &filepath,
+                                         const ComponentMap &components)
+{
+    std::ifstream file(filepath);
+    if (file.fail())
+    {
+        throw std::invalid_argument("stimulus file not found");
+    }
+
+    std::vector<StimulusEvent> events;
+    std::string                line;
+
+    for (size_t i = 1; getline(file, line); ++i)
+    {
+        std::istringstream stream(line);
+        std::string        tick_str, id, action, value_str;
+        if (!(stream >> tick_str) || tick_str[0] == '#')
+        {
+            continue;
+        }
+
+        std::string at_line = "stimulus line " + std::to_string(i) + ": ";
+        if (!(stream >> id >> action))
+        {
+            throw std::invalid_argument(at_line + "missing fields");
+        }
+
+        StimulusEvent event;
+        event.line   = i;
+        event.action = action;
+        event.value  = 0;
+        try
+        {
+            event.tick      = parse_uint(tick_str, "tick", MAX_TICKS);
+            event.component = find_component(components, id);
+
+            std::string ctype = event.component->ctype();
+            if (action == "set" || action == "key")
+            {
+                if (!(stream >> value_str))
+                {
+                    throw std::invalid_argument("missing value");
+                }
+                event.value = parse_uint(value_str, "value");
+            }
+
+            bool valid;
+            if (action == "press" || action == "release")
+            {
+                valid = ctype == "BUTTON";
+            }
+            else if (action == "toggle")
+            {
+                valid = ctype == "SWITCH";
+            }
+            else if (action == "set")
+            {
+                valid = (ctype == "SWITCH" || ctype == "CONSTANT") &&
+                        event.value <= 1;
+            }
+            else if (action == "key")
+            {
+                valid = ctype == "KEYPAD" && event.value < 16;
+            }
+            else
+            {
+                throw std::invalid_argument("unknown action " + action);
+            }
+
+            if (!valid)
+            {
+                throw std::invalid_argument("cannot apply " + action +
+                                            " to component " + id);
+            }
+        }
+        catch (const std::invalid_argument &e)
+        {
+            throw std::invalid_argument(at_line + e.what());
+        }
+
+        events.push_back(event);
+    }
+
+    std::stable_sort(events.begin(),
+                     events.end(),
+                     [](const StimulusEvent &a, const StimulusEvent &b)
+                     { return a.tick < b.tick; });
+
+    return events;
+}
+
+void apply_event(const StimulusEvent &event)
+{
+    if (event.action == "press")
+    {
+        static_cast<model::input::Button *>(event.component)->press();
+    }
+    else if (event.action == "release")
+    {
+        static_cast<model::input::Button *>(event.component)->release();
+    }
+    else if (event.action == "toggle")
+    {
+        static_cast<model::input::Switch *>(event.component)->toggle();
+    }
+    else if (event.action == "set")
+    {
+        event.component->set_params(std::to_string(event.value));
+    }
+    else if (event.action == "key")
+    {
+        static_cast<model::input::Keypad *>(event.component)
+          ->set_key(event.value);
+    }
+}
+
+struct PrintTarget
+{
+    std::string id;
+    Component  *component;
+    // evaluation to print, or all if negative
+    int out;
+};
+
+std::vector<PrintTarget> parse_print(const std::string             &print,
+                                     const model::file::CircuitFile &file,
+                                     const std::vector<Component *> &loaded,
+                                     const ComponentMap &components)
+{
+    std::vector<PrintTarget> targets;
+
+    if (print.empty())
+    {
+        for (size_t i = 0; i < loaded.size(); ++i)
+        {
+            if (loaded[i]->n_outputs() == 0)
+            {
+                targets.push_back(
+                  { std::string(file.components[i].id), loaded[i], -1 });
+            }
+        }
+        return targets;
+    }
+
+    utils::StringSplitter splitter(print, ',');
+    while (splitter.has_next())
+    {
+        std::string target = splitter.next();
+        if (target.find(':') == std::string::npos)
+        {
+            targets.push_back(
+              { target, find_component(components, target), -1 });
+        }
+        else
+        {
+            model::watch::Probe probe = parse_probe(components, target);
+            targets.push_back({ target.substr(0, target.find(':')),
+                                probe.component,
+                                static_cast<int>(probe.out) });
+        }
+    }
+
+    return targets;
+}
+
+char state_char(model::State state)
+{
+    switch (state)
+    {
+    case model::State::ZERO:
+        return '0';
+    case model::State::ONE:
+        return '1';
+    default:
+        return 'Z';
+    }
+}
+
+void print_outputs(const std::vector<PrintTarget> &targets,
+                   std::uint64_t                   tick)
+{
+    std::cout << "tick " << tick << ":";
+    for (const auto &target : targets)
+    {
+        std::cout << ' ' << target.id;
+        if (target.out >= 0)
+        {
+            std::cout << ':' << target.out << '='
+                      << state_char(target.component->evaluate(target.out));
+            continue;
+        }
+
+        std::cout << '=';
+        for (unsigned int i = 0; i < target.component->n_evals(); ++i)
+        {
+            std::cout << state_char(target.component->evaluate(i));
+        }
+    }
+    std::cout << "\n";
+}
+
+bool ends_with(const std::string &str, const std::string &suffix)
+{
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void convert(const model::file::CircuitFile &circuit_file,
+             const std::string              &filepath)
+{
+    if (ends_with(filepath, ".lsb"))
+    {
+        model::file::write_binary(filepath, circuit_file);
+    }
+    else
+    {
+        model::file::write(filepath, circuit_file);
+    }
+}
+
+int run(const Options &options)
+{
+    model::file::CircuitFile circuit_file =
+      model::file::read_any(options.filepath, options.n_threads);
+
+    if (!options.convert_filepath.empty())
+    {
+        convert(circuit_file, options.convert_filepath);
+        return 0;
+    }
+
+    model::circuit::Circuit circuit;
+    std::vector<Component *> loaded =
+      model::file::load(circuit_file, circuit, options.n_threads);
+
+    ComponentMap components;
+    components.reserve(loaded.size());
+    for (size_t i = 0; i < loaded.size(); ++i)
+    {
+        components[std::string(circuit_file.components[i].id)] = loaded[i];
+    }
+
+    for (const auto &condition : options.conditions)
+    {
+        circuit.add_watchpoint(parse_condition(components, condition));
+    }
+
+    std::vector<StimulusEvent> events;
+    if (!options.stimulus_filepath.empty())
+    {
+        events = read_stimulus(options.stimulus_filepath, components);
+    }
+
+    std::vector<PrintTarget> targets =
+      parse_print(options.print, circuit_file, loaded, components);
+
+    std::uint64_t ticks =
+      options.ticks_given ? options.ticks : circuit_file.frequency;
+
+    bool   condition_met = false;
+    size_t next_event    = 0;
+
+    circuit.set_profiling(!options.profile_filepath.empty());
+
+    std::chrono::steady_clock::duration elapsed { 0 };
+
+    while (circuit.total_ticks() < ticks)
+    {
+        std::uint64_t curr = circuit.total_ticks();
+        for (; next_event < events.size() && events[next_event].tick <= curr;
+             ++next_event)
+        {
+            apply_event(events[next_event]);
+        }
+
+        std::uint64_t stop = ticks;
+        if (next_event < events.size())
+        {
+            stop = std::min<std::uint64_t>(stop, events[next_event].tick);
+        }
+        if (options.every > 0)
+        {
+            // the next multiple of every, unless it does not fit
+            std::uint64_t last = curr - curr % options.every;
+            if (last <= MAX_TICKS - options.every)
+            {
+                stop = std::min(stop, last + options.every);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        circuit.run(stop - curr);
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        if (options.every > 0 && circuit.total_ticks() % options.every == 0)
+        {
+            print_outputs(targets, circuit.total_ticks());
+        }
+
+        if (!circuit.triggered_watchpoints().empty())
+        {
+            condition_met = true;
+            break;
+        }
+    }
+
+    if (options.every == 0 || circuit.total_ticks() % options.every != 0)
+    {
+        print_outputs(targets, circuit.total_ticks());
+    }
+
+    if (!options.profile_filepath.empty())
+    {
+        std::ofstream profile_file(options.profile_filepath);
+        if (profile_file.fail())
+        {
+            throw std::invalid_argument("Profile file could not be created");
+        }
+        circuit.profile().write_json(profile_file);
+    }
+
+    if (!options.quiet)
+    {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        double tick_rate =
+          seconds > 0 ? circuit.total_ticks() / seconds : 0.0;
+
+        std::cout << "components: " << loaded.size() << "\n"
+                  << "ticks: " << circuit.total_ticks() << "\n"
+                  << "time: " << seconds << " s\n"
+                  << "throughput: " << tick_rate << " ticks/s, "
+                  << tick_rate * loaded.size()
+                  << " component evaluations/s\n";
+        if (!options.conditions.empty())
+        {
+            std::cout << "condition met: " << (condition_met ? "yes" : "no")
+                      << "\n";
+        }
+    }
+
+    return options.conditions.empty() || condition_met ? 0 : 2;
+}
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        return run(parse_options(argc, argv));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "logicsim-cli: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,269 @@
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "model/binary_file.hpp"
+#include "model/circuit_file.hpp"
+#include "tools/generators.hpp"
+
+#include "utils.hpp"
+
+/* Circuit generator
+ * Writes circuit files of a chosen kind and size, laying out instances of the
+ * circuit on a grid, so that large designs can be reproduced for load, render
+ * and simulation performance testing
+ * The same options always produce the same file
+ */
+
+namespace
+{
+using namespace logicsim;
+
+const char *USAGE =
+  "Usage: logicsim-gen [options] CIRCUIT\n"
+  "Circuits (SIZE is given by --size):\n"
+  "  counter      SIZE-bit counter of TFlipFlops (default: 16)\n"
+  "  adder        SIZE-bit ripple-carry adder (default: 32)\n"
+  "  multiplier   SIZE x SIZE-bit array multiplier (default: 16)\n"
+  "  lfsr         SIZE-bit linear feedback shift register (default: 16)\n"
+  "  regfile      register file of 8 registers of SIZE bits (default: 8)\n"
+  "  dag          random graph of SIZE gates (default: 1024)\n"
+  "  chain        chain of SIZE connectors (default: 1024)\n"
+  "  muxtree      tree of multiplexers with 8^SIZE inputs (default: 3)\n"
+  "  dectree      tree of decoders with 8^SIZE outputs (default: 3)\n"
+  "Options:\n"
+  "  -s, --size N          size of each instance\n"
+  "  -c, --count N         number of instances (default: 1)\n"
+  "  -t, --target N        number of instances giving at least N components\n"
+  "                        overall; overrides --count\n"
+  "  -r, --seed N          seed for random circuits (default: 1)\n"
+  "  -f, --frequency N     simulation frequency (default: 1000)\n"
+  "  -o, --output FILE     file to write (default: standard output); written\n"
+  "                        in binary format if it ends in .lsb\n"
+  "  -h, --help            show this message\n";
+
+struct Options
+{
+    std::string  circuit;
+    unsigned int size       = 0;
+    bool         size_given = false;
+    unsigned int count      = 1;
+    unsigned int target     = 0;
+    unsigned int seed       = 1;
+    unsigned int frequency  = 1000;
+    std::string  output;
+};
+
+struct Generator
+{
+    unsigned int default_size;
+    // adds an instance of the given size; seed is used by random circuits
+    std::function<void(tools::CircuitBuilder &, unsigned int size,
+                       unsigned int seed)>
+      generate;
+};
+
+const std::map<std::string, Generator> GENERATORS = {
+    { "counter",
+      { 16,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::counter(builder, size); } } },
+    { "adder",
+      { 32,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::ripple_carry_adder(builder, size); } } },
+    { "multiplier",
+      { 16,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::array_multiplier(builder, size); } } },
+    { "lfsr",
+      { 16,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::lfsr(builder, size); } } },
+    { "regfile",
+      { 8,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::register_file(builder, 3, size); } } },
+    { "dag",
+      { 1024,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int seed)
+        { tools::random_dag(builder, size, seed); } } },
+    { "chain",
+      { 1024,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::connector_chain(builder, size); } } },
+    { "muxtree",
+      { 3,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::mux_tree(builder, size); } } },
+    { "dectree",
+      { 3,
+        [](tools::CircuitBuilder &builder, unsigned int size, unsigned int)
+        { tools::decoder_tree(builder, size); } } }
+};
+
+unsigned int parse_uint(const std::string &str, const std::string &what)
+{
+    if (!utils::is_positive_int(str))
+    {
+        throw std::invalid_argument("invalid " + what + ": " + str);
+    }
+
+    try
+    {
+        return std::stoul(str);
+    }
+    catch (const std::out_of_range &)
+    {
+        throw std::invalid_argument("invalid " + what + ": " + str);
+    }
+}
+
+Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+        {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (arg.empty() || arg[0] != '-')
+        {
+            if (!options.circuit.empty())
+            {
+                throw std::invalid_argument("more than one circuit given");
+            }
+            options.circuit = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        std::string value = argv[++i];
+
+        if (arg == "-s" || arg == "--size")
+        {
+            options.size       = parse_uint(value, "size");
+            options.size_given = true;
+        }
+        else if (arg == "-c" || arg == "--count")
+        {
+            options.count = parse_uint(value, "count");
+        }
+        else if (arg == "-t" || arg == "--target")
+        {
+            options.target = parse_uint(value, "target");
+        }
+        else if (arg == "-r" || arg == "--seed")
+        {
+            options.seed = parse_uint(value, "seed");
+        }
+        else if (arg == "-f" || arg == "--frequency")
+        {
+            options.frequency = parse_uint(value, "frequency");
+            if (options.frequency == 0)
+            {
+                throw std::invalid_argument("invalid frequency: " + value);
+            }
+        }
+        else if (arg == "-o" || arg == "--output")
+        {
+            options.output = value;
+        }
+        else
+        {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+
+    if (options.circuit.empty())
+    {
+        throw std::invalid_argument("no circuit given");
+    }
+
+    return options;
+}
+
+bool ends_with(const std::string &str, const std::string &suffix)
+{
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int run(const Options &options)
+{
+    auto it = GENERATORS.find(options.circuit);
+    if (it == GENERATORS.end())
+    {
+        throw std::invalid_argument("unknown circuit " + options.circuit);
+    }
+    const Generator &generator = it->second;
+
+    unsigned int size =
+      options.size_given ? options.size : generator.default_size;
+    unsigned int count = options.count;
+
+    if (options.target > 0)
+    {
+        tools::CircuitBuilder instance;
+        generator.generate(instance, size, options.seed);
+        count = instance.size() == 0
+                  ? 1
+                  : (options.target + instance.size() - 1) / instance.size();
+    }
+
+    tools::CircuitBuilder builder(options.frequency);
+    unsigned int          seed = options.seed;
+    tools::tile(builder,
+                count,
+                [&generator, size, &seed](tools::CircuitBuilder &builder)
+                { generator.generate(builder, size, seed++); });
+
+    if (ends_with(options.output, ".lsb"))
+    {
+        model::file::write_binary(options.output,
+                                  model::file::parse(builder.str()));
+    }
+    else if (!options.output.empty())
+    {
+        std::ofstream file(options.output);
+        if (file.fail())
+        {
+            throw std::invalid_argument("File could not be created");
+        }
+        builder.write(file);
+    }
+    else
+    {
+        builder.write(std::cout);
+    }
+
+    std::cerr << builder.size() << " components in " << count
+              << (count == 1 ? " instance\n" : " instances\n");
+
+    return 0;
+}
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        return run(parse_options(argc, argv));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "logicsim-gen: " << e.what() << "\n";
+        return 1;
+    }
+}